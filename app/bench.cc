@@ -1,14 +1,50 @@
 #include <set>
+#include <list>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <cstring>
 #include <random>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include <malloc.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include <benchmark/benchmark.h>
 
 #include "splaytree.h"
+#include "splaytree_u64.h"
+#include "splay_block.h"
+#include "splay_arena.h"
+#include "splay_pool.h"
+#include "splay_checkpoint.h"
+#include "splay_rel.h"
+#include "splay_interval.h"
+#include "splay_seq.h"
+#include "splay_cache.h"
+#include "splay_pq.h"
+#include "splay_parallel.h"
+#include "splay_set.h"
+#include "splay_simd.h"
 #include "avltree.h"
 #include "rbwrap.h"
 
+#include "perf_counters.h"
+#include "splaytree.hpp"
+
+// the std::set workloads (BM_STLSet_*) are templates, run on splay::set as well
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+#define SPLAY_SET_WRAPPER
+#endif
+
 #define NUMBER_ELEMENTS 100000
 
 std::default_random_engine generator;
@@ -43,8 +79,80 @@ inline int compare(T2 *lhs, T2 *rhs) {
   return aa->key - bb->key;
 }
 
+// per-operation latency, measured with the TSC and bucketed into a log-linear histogram
+// (16 sub-buckets per power of two, ~6% precision) so that recording stays cheap
+double ns_per_tick = 1.0;
+
+inline uint64_t tsc_now() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_lfence();
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void calibrate_tsc() {
+  auto start = std::chrono::steady_clock::now();
+  uint64_t begin = tsc_now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {}
+  uint64_t ticks = tsc_now() - begin;
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  ns_per_tick = (double)elapsed.count() / ticks;
+}
+
+class LatencyHistogram {
+public:
+  LatencyHistogram() : counts(), total(0), max(0) {}
+
+  void record(uint64_t ticks) {
+    counts[bucket(ticks)] ++;
+    total ++;
+    if (ticks > max) max = ticks;
+  }
+
+  uint64_t percentile(double p) const {
+    uint64_t rank = (uint64_t) (p * total), seen = 0;
+    for(int idx = 0; idx < NUMBER_BUCKETS; idx ++) {
+      seen += counts[idx];
+      if (seen > rank) return std::min(lower_bound(idx), max);
+    }
+    return max;
+  }
+
+  void report(benchmark::State& state) const {
+    state.counters["p50_ns"]    = percentile(0.5) * ns_per_tick;
+    state.counters["p99_ns"]    = percentile(0.99) * ns_per_tick;
+    state.counters["p99.9_ns"]  = percentile(0.999) * ns_per_tick;
+    state.counters["max_ns"]    = max * ns_per_tick;
+  }
+
+private:
+  static const int SUB_BITS = 4;
+  static const int NUMBER_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+  static int bucket(uint64_t v) {
+    if (v < (1 << SUB_BITS)) return (int) v;
+    int shift = 63 - __builtin_clzll(v) - SUB_BITS;
+    return ((shift + 1) << SUB_BITS) + (int) ((v >> shift) & ((1 << SUB_BITS) - 1));
+  }
+
+  static uint64_t lower_bound(int idx) {
+    if (idx < (1 << SUB_BITS)) return idx;
+    int shift = (idx >> SUB_BITS) - 1;
+    return (uint64_t) ((1 << SUB_BITS) + (idx & ((1 << SUB_BITS) - 1))) << shift;
+  }
+
+  uint64_t counts[NUMBER_BUCKETS];
+  uint64_t total;
+  uint64_t max;
+};
+
 // all benchmarks
 static void BM_SplayTree_Append(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct splay_tree tree;
     struct kv_node data[NUMBER_ELEMENTS];
@@ -56,9 +164,12 @@ static void BM_SplayTree_Append(benchmark::State& state) {
       splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_AVLTree_Append(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct avl_tree tree;
     struct kv_node_avl data[NUMBER_ELEMENTS];
@@ -70,9 +181,12 @@ static void BM_AVLTree_Append(benchmark::State& state) {
       avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_Append(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct rb_root tree;
     struct kv_node_rb data[NUMBER_ELEMENTS];
@@ -84,19 +198,26 @@ static void BM_RBTree_Append(benchmark::State& state) {
       rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
-static void BM_SETSet_Append(benchmark::State& state) {
+template <class Set>
+static void BM_STLSet_Append(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
-    std::set<int> data;
+    Set data;
 
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
       data.insert(idx + 1);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_SplayTree_InsertRandom(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct splay_tree tree;
     struct kv_node data[NUMBER_ELEMENTS];
@@ -108,9 +229,12 @@ static void BM_SplayTree_InsertRandom(benchmark::State& state) {
       splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_AVLTree_InsertRandom(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct avl_tree tree;
     struct kv_node_avl data[NUMBER_ELEMENTS];
@@ -122,9 +246,12 @@ static void BM_AVLTree_InsertRandom(benchmark::State& state) {
       avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_InsertRandom(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     struct rb_root tree;
     struct kv_node_rb data[NUMBER_ELEMENTS];
@@ -136,16 +263,21 @@ static void BM_RBTree_InsertRandom(benchmark::State& state) {
       rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
+template <class Set>
 static void BM_STLSet_InsertRandom(benchmark::State& state) {
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
-    std::set<int> data;
+    Set data;
 
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
       data.insert(values[idx]);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_SplayTree_LoopSequentially(benchmark::State& state) {
@@ -158,13 +290,41 @@ static void BM_SplayTree_LoopSequentially(benchmark::State& state) {
     data[idx].key = idx + 1;
     splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
   }
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     splay_node *cur = splay_first(&tree);
     for(int idx = 1; idx < NUMBER_ELEMENTS; idx ++) {
       cur = splay_next(&tree, cur, compare<kv_node, struct splay_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
+}
+
+#ifdef _SPLAY_XOR_SIBLING
+static void BM_SplayTree_LoopCursor(benchmark::State& state) {
+  struct splay_tree tree;
+  struct kv_node data[NUMBER_ELEMENTS];
+
+  splay_tree_init(&tree);
+
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+  PerfCounters perf;
+  perf.start();
+  for (auto _ : state) {
+    splay_cursor cursor;
+    splay_cursor_first(&tree, &cursor);
+    for(int idx = 1; idx < NUMBER_ELEMENTS; idx ++) {
+      splay_cursor_next(&cursor);
+    }
+    benchmark::DoNotOptimize(cursor.node);
+  }
+  perf.report(state, NUMBER_ELEMENTS);
 }
+#endif
 
 static void BM_AVLTree_LoopSequentially(benchmark::State& state) {
   struct avl_tree tree;
@@ -176,12 +336,15 @@ static void BM_AVLTree_LoopSequentially(benchmark::State& state) {
     data[idx].key = idx + 1;
     avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
   }
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     avl_node *cur = avl_first(&tree);
     for(int idx = 1; idx < NUMBER_ELEMENTS; idx ++) {
       cur = avl_next(cur);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_LoopSequentially(benchmark::State& state) {
@@ -194,12 +357,15 @@ static void BM_RBTree_LoopSequentially(benchmark::State& state) {
     data[idx].key = idx + 1;
     rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
   }
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     rb_node *cur = rb_first(&tree);
     for(int idx = 1; idx < NUMBER_ELEMENTS; idx ++) {
       cur = rb_next(cur);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_SplayTree_SearchRandomly(benchmark::State& state) {
@@ -213,6 +379,8 @@ static void BM_SplayTree_SearchRandomly(benchmark::State& state) {
     splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
   }
 
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     kv_node query;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -220,6 +388,7 @@ static void BM_SplayTree_SearchRandomly(benchmark::State& state) {
       auto cur = splay_search(&tree, &query.node, compare<kv_node, struct splay_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_AVLTree_SearchRandomly(benchmark::State& state) {
@@ -233,6 +402,8 @@ static void BM_AVLTree_SearchRandomly(benchmark::State& state) {
     avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
   }
 
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     kv_node_avl query;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -240,6 +411,7 @@ static void BM_AVLTree_SearchRandomly(benchmark::State& state) {
       auto cur = avl_search(&tree, &query.node, compare<kv_node_avl, struct avl_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_SearchRandomly(benchmark::State& state) {
@@ -253,6 +425,8 @@ static void BM_RBTree_SearchRandomly(benchmark::State& state) {
     rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
   }
 
+  PerfCounters perf;
+  perf.start();
   for (auto _ : state) {
     kv_node_rb query;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -260,9 +434,11 @@ static void BM_RBTree_SearchRandomly(benchmark::State& state) {
       auto cur = rbwrap_search(&tree, &query.node, compare<kv_node_rb, struct rb_node>);
     }
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_SplayTree_DeleteSequentially(benchmark::State& state) {
+  PerfCounters perf;
   struct splay_tree tree;
   struct kv_node data[NUMBER_ELEMENTS];
 
@@ -275,17 +451,21 @@ static void BM_SplayTree_DeleteSequentially(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     for(int idx = NUMBER_ELEMENTS - 1; idx >= 0; idx --) {
       splay_delete(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_AVLTree_DeleteSequentially(benchmark::State& state) {
+  PerfCounters perf;
   struct avl_tree tree;
   struct kv_node_avl data[NUMBER_ELEMENTS];
 
@@ -298,17 +478,21 @@ static void BM_AVLTree_DeleteSequentially(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     for(int idx = NUMBER_ELEMENTS - 1; idx >= 0; idx --) {
       avl_remove(&tree, &data[idx].node);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_DeleteSequentially(benchmark::State& state) {
+  PerfCounters perf;
   struct rb_root tree;
   struct kv_node_rb data[NUMBER_ELEMENTS];
 
@@ -321,18 +505,23 @@ static void BM_RBTree_DeleteSequentially(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     for(int idx = NUMBER_ELEMENTS - 1; idx >= 0; idx --) {
       rb_erase(&data[idx].node, &tree);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
+template <class Set>
 static void BM_STLSet_DeleteSequentially(benchmark::State& state) {
-  std::set<int> data;
+  PerfCounters perf;
+  Set data;
 
   for (auto _ : state) {
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -340,17 +529,21 @@ static void BM_STLSet_DeleteSequentially(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     for(int idx = NUMBER_ELEMENTS - 1; idx >= 0; idx --) {
       data.erase(idx + 1);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_SplayTree_DeleteRandomly(benchmark::State& state) {
+  PerfCounters perf;
   struct splay_tree tree;
   struct kv_node data[NUMBER_ELEMENTS];
 
@@ -363,19 +556,23 @@ static void BM_SplayTree_DeleteRandomly(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     kv_node query;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
       query.key = values[idx];
       splay_delete(&tree, &query.node, compare<kv_node, struct splay_node>);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_AVLTree_DeleteRandomly(benchmark::State& state) {
+  PerfCounters perf;
   struct avl_tree tree;
   struct kv_node_avl data[NUMBER_ELEMENTS];
 
@@ -388,6 +585,7 @@ static void BM_AVLTree_DeleteRandomly(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     kv_node_avl query;
     avl_node *cursor;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -395,14 +593,17 @@ static void BM_AVLTree_DeleteRandomly(benchmark::State& state) {
       cursor = avl_search(&tree, &query.node, compare<kv_node_avl, struct avl_node>);
       avl_remove(&tree, cursor);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
 static void BM_RBTree_DeleteRandomly(benchmark::State& state) {
+  PerfCounters perf;
   struct rb_root tree;
   struct kv_node_rb data[NUMBER_ELEMENTS];
 
@@ -415,6 +616,7 @@ static void BM_RBTree_DeleteRandomly(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     kv_node_rb query;
     rb_node *cursor;
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -422,15 +624,19 @@ static void BM_RBTree_DeleteRandomly(benchmark::State& state) {
       cursor = rbwrap_search(&tree, &query.node, compare<kv_node_rb, struct rb_node>);
       rb_erase(cursor, &tree);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
 }
 
+template <class Set>
 static void BM_STLSet_DeleteRandomly(benchmark::State& state) {
-  std::set<int> data;
+  PerfCounters perf;
+  Set data;
 
   for (auto _ : state) {
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
@@ -438,25 +644,1764 @@ static void BM_STLSet_DeleteRandomly(benchmark::State& state) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
+    perf.start();
     for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
       data.erase(values[idx]);
     }
+    perf.stop();
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     state.SetIterationTime(elapsed_seconds.count());
   }
+  perf.report(state, NUMBER_ELEMENTS);
+}
+
+static void BM_SplayTree_InsertLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  std::vector<kv_node> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    struct splay_tree tree;
+    splay_tree_init(&tree);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx];
+      uint64_t start = tsc_now();
+      splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+      hist.record(tsc_now() - start);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_AVLTree_InsertLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  std::vector<kv_node_avl> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    struct avl_tree tree;
+    avl_init(&tree, NULL);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx];
+      uint64_t start = tsc_now();
+      avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
+      hist.record(tsc_now() - start);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_RBTree_InsertLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  std::vector<kv_node_rb> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    struct rb_root tree;
+    rb_root_init(&tree, NULL);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx];
+      uint64_t start = tsc_now();
+      rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
+      hist.record(tsc_now() - start);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_SplayTree_SearchLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct splay_tree tree;
+  std::vector<kv_node> data(NUMBER_ELEMENTS);
+
+  splay_tree_init(&tree);
+
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      auto cur = splay_search(&tree, &query.node, compare<kv_node, struct splay_node>);
+      hist.record(tsc_now() - start);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_AVLTree_SearchLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct avl_tree tree;
+  std::vector<kv_node_avl> data(NUMBER_ELEMENTS);
+
+  avl_init(&tree, NULL);
+
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = idx + 1;
+    avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_avl query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      auto cur = avl_search(&tree, &query.node, compare<kv_node_avl, struct avl_node>);
+      hist.record(tsc_now() - start);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_RBTree_SearchLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct rb_root tree;
+  std::vector<kv_node_rb> data(NUMBER_ELEMENTS);
+
+  rb_root_init(&tree, NULL);
+
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = idx + 1;
+    rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_rb query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      auto cur = rbwrap_search(&tree, &query.node, compare<kv_node_rb, struct rb_node>);
+      hist.record(tsc_now() - start);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  hist.report(state);
+}
+
+static void BM_SplayTree_DeleteLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct splay_tree tree;
+  std::vector<kv_node> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    splay_tree_init(&tree);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = idx + 1;
+      splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      splay_delete(&tree, &query.node, compare<kv_node, struct splay_node>);
+      hist.record(tsc_now() - start);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  hist.report(state);
+}
+
+static void BM_AVLTree_DeleteLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct avl_tree tree;
+  std::vector<kv_node_avl> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    avl_init(&tree, NULL);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = idx + 1;
+      avl_insert(&tree, &data[idx].node, compare<kv_node_avl, struct avl_node>);
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    kv_node_avl query;
+    avl_node *cursor;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      cursor = avl_search(&tree, &query.node, compare<kv_node_avl, struct avl_node>);
+      if (cursor) avl_remove(&tree, cursor);
+      hist.record(tsc_now() - start);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  hist.report(state);
+}
+
+static void BM_RBTree_DeleteLatency(benchmark::State& state) {
+  LatencyHistogram hist;
+  struct rb_root tree;
+  std::vector<kv_node_rb> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    rb_root_init(&tree, NULL);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = idx + 1;
+      rbwrap_insert(&tree, &data[idx].node, compare<kv_node_rb, struct rb_node>);
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    kv_node_rb query;
+    rb_node *cursor;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx];
+      uint64_t start = tsc_now();
+      cursor = rbwrap_search(&tree, &query.node, compare<kv_node_rb, struct rb_node>);
+      if (cursor) rb_erase(cursor, &tree);
+      hist.record(tsc_now() - start);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  hist.report(state);
+}
+
+// concurrent access patterns: state.range(0) is the percentage of reads, the rest are
+// writes that toggle a key (delete it if present, insert it otherwise). Every container
+// sits behind a plain std::mutex since a splay search restructures the tree as well.
+#define MT_BATCH 1000
+
+std::mutex shared_mutex;
+struct splay_tree shared_splay;
+std::vector<kv_node> shared_splay_data;
+
+template <class Set>
+Set &shared_container() {
+  static Set set;
+  return set;
+}
+
+static void BM_SplayTree_MutexShared(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    splay_tree_init(&shared_splay);
+    shared_splay_data.assign(2 * NUMBER_ELEMENTS, kv_node());
+    for(int idx = 0; idx < 2 * NUMBER_ELEMENTS; idx += 2) {
+      shared_splay_data[idx].key = idx + 1;
+      splay_insert(&shared_splay, &shared_splay_data[idx].node, compare<kv_node, struct splay_node>);
+    }
+  }
+
+  std::minstd_rand rng(state.thread_index() + 1);
+  int readRatio = state.range(0);
+  kv_node query;
+  for (auto _ : state) {
+    for(int idx = 0; idx < MT_BATCH; idx ++) {
+      query.key = rng() % (2 * NUMBER_ELEMENTS) + 1;
+      bool isRead = (int) (rng() % 100) < readRatio;
+
+      std::lock_guard<std::mutex> guard(shared_mutex);
+      auto cur = splay_search(&shared_splay, &query.node, compare<kv_node, struct splay_node>);
+      if (isRead) {
+        benchmark::DoNotOptimize(cur);
+      } else if (cur) {
+        splay_delete(&shared_splay, &query.node, compare<kv_node, struct splay_node>);
+      } else {
+        kv_node *entry = &shared_splay_data[query.key - 1];
+        entry->key = query.key;
+        splay_insert(&shared_splay, &entry->node, compare<kv_node, struct splay_node>);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * MT_BATCH);
+}
+
+// one tree per thread, still behind an (uncontended) mutex so the locking cost matches
+static void BM_SplayTree_PerThread(benchmark::State& state) {
+  std::mutex local_mutex;
+  struct splay_tree tree;
+  std::vector<kv_node> data(2 * NUMBER_ELEMENTS);
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < 2 * NUMBER_ELEMENTS; idx += 2) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+
+  std::minstd_rand rng(state.thread_index() + 1);
+  int readRatio = state.range(0);
+  kv_node query;
+  for (auto _ : state) {
+    for(int idx = 0; idx < MT_BATCH; idx ++) {
+      query.key = rng() % (2 * NUMBER_ELEMENTS) + 1;
+      bool isRead = (int) (rng() % 100) < readRatio;
+
+      std::lock_guard<std::mutex> guard(local_mutex);
+      auto cur = splay_search(&tree, &query.node, compare<kv_node, struct splay_node>);
+      if (isRead) {
+        benchmark::DoNotOptimize(cur);
+      } else if (cur) {
+        splay_delete(&tree, &query.node, compare<kv_node, struct splay_node>);
+      } else {
+        kv_node *entry = &data[query.key - 1];
+        entry->key = query.key;
+        splay_insert(&tree, &entry->node, compare<kv_node, struct splay_node>);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * MT_BATCH);
+}
+
+template <class Set>
+static void BM_STLSet_MutexShared(benchmark::State& state) {
+  Set &shared_set = shared_container<Set>();
+  if (state.thread_index() == 0) {
+    shared_set.clear();
+    for(int idx = 0; idx < 2 * NUMBER_ELEMENTS; idx += 2) {
+      shared_set.insert(idx + 1);
+    }
+  }
+
+  std::minstd_rand rng(state.thread_index() + 1);
+  int readRatio = state.range(0);
+  for (auto _ : state) {
+    for(int idx = 0; idx < MT_BATCH; idx ++) {
+      int key = rng() % (2 * NUMBER_ELEMENTS) + 1;
+      bool isRead = (int) (rng() % 100) < readRatio;
+
+      std::lock_guard<std::mutex> guard(shared_mutex);
+      if (isRead) {
+        benchmark::DoNotOptimize(shared_set.find(key));
+      } else if (!shared_set.erase(key)) {
+        shared_set.insert(key);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * MT_BATCH);
+}
+
+// memory footprint: every element is its own heap allocation, as in an index whose
+// records are allocated one by one, and the heap growth is divided by the element count.
+// Build with `make benchmark SPLAY_FLAGS=...` to compare splay node layouts.
+size_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks;
+#else
+  return (size_t) mallinfo().uordblks;
+#endif
+}
+
+void report_memory(benchmark::State& state, size_t before, size_t after, size_t nodeSize) {
+  state.counters["bytes_per_elem"] = (double) (after - before) / state.range(0);
+  state.counters["node_bytes"] = nodeSize;
+}
+
+static void BM_SplayTree_Memory(benchmark::State& state) {
+  int count = state.range(0);
+  std::vector<kv_node *> data(count);
+
+  for (auto _ : state) {
+    struct splay_tree tree;
+    splay_tree_init(&tree);
+
+    size_t before = heap_in_use();
+    for(int idx = 0; idx < count; idx ++) {
+      data[idx] = new kv_node();
+      data[idx]->key = idx + 1;
+      splay_insert(&tree, &data[idx]->node, compare<kv_node, struct splay_node>);
+    }
+    report_memory(state, before, heap_in_use(), sizeof(kv_node));
+
+    for(int idx = 0; idx < count; idx ++) {
+      delete data[idx];
+    }
+  }
+}
+
+static void BM_AVLTree_Memory(benchmark::State& state) {
+  int count = state.range(0);
+  std::vector<kv_node_avl *> data(count);
+
+  for (auto _ : state) {
+    struct avl_tree tree;
+    avl_init(&tree, NULL);
+
+    size_t before = heap_in_use();
+    for(int idx = 0; idx < count; idx ++) {
+      data[idx] = new kv_node_avl();
+      data[idx]->key = idx + 1;
+      avl_insert(&tree, &data[idx]->node, compare<kv_node_avl, struct avl_node>);
+    }
+    report_memory(state, before, heap_in_use(), sizeof(kv_node_avl));
+
+    for(int idx = 0; idx < count; idx ++) {
+      delete data[idx];
+    }
+  }
 }
 
+static void BM_RBTree_Memory(benchmark::State& state) {
+  int count = state.range(0);
+  std::vector<kv_node_rb *> data(count);
+
+  for (auto _ : state) {
+    struct rb_root tree;
+    rb_root_init(&tree, NULL);
+
+    size_t before = heap_in_use();
+    for(int idx = 0; idx < count; idx ++) {
+      data[idx] = new kv_node_rb();
+      data[idx]->key = idx + 1;
+      rbwrap_insert(&tree, &data[idx]->node, compare<kv_node_rb, struct rb_node>);
+    }
+    report_memory(state, before, heap_in_use(), sizeof(kv_node_rb));
+
+    for(int idx = 0; idx < count; idx ++) {
+      delete data[idx];
+    }
+  }
+}
+
+template <class Set> struct set_node_bytes;
+
+// _Rb_tree_node<int>: color, parent, left, right and the value
+template <> struct set_node_bytes<std::set<int>> {
+  static const size_t value = sizeof(std::_Rb_tree_node<int>);
+};
+
+#ifdef SPLAY_SET_WRAPPER
+template <> struct set_node_bytes<splay::set<int>> {
+  static const size_t value = sizeof(splay::detail::node<int>);
+};
+#endif
+
+template <class Set>
+static void BM_STLSet_Memory(benchmark::State& state) {
+  int count = state.range(0);
+
+  for (auto _ : state) {
+    Set data;
+
+    size_t before = heap_in_use();
+    for(int idx = 0; idx < count; idx ++) {
+      data.insert(idx + 1);
+    }
+    report_memory(state, before, heap_in_use(), set_node_bytes<Set>::value);
+  }
+}
+
+// search at sizes well past the last level cache, against the frozen Eytzinger snapshot
+static void BM_SplayTree_SearchRandomlyLarge(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node> data(count);
+  std::vector<int> queries(NUMBER_ELEMENTS);
+
+  splay_tree_init(&tree);
+
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    queries[idx] = generator() % count + 1;
+  }
+
+  for (auto _ : state) {
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = queries[idx];
+      auto cur = splay_search(&tree, &query.node, compare<kv_node, struct splay_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+static void BM_SplayTree_FrozenSearchRandomly(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree tree;
+  struct splay_frozen frozen;
+  std::vector<kv_node> data(count);
+  std::vector<int> queries(NUMBER_ELEMENTS);
+
+  splay_tree_init(&tree);
+
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    queries[idx] = generator() % count + 1;
+  }
+  splay_freeze(&tree, &frozen);
+
+  for (auto _ : state) {
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = queries[idx];
+      auto cur = splay_frozen_search(&frozen, &query.node, compare<kv_node, struct splay_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  splay_thaw(&frozen, &tree);
+}
+
+// uint64_t-keyed tree with inline keys against the generic tree driven by a comparator
+class kv_node_u64 {
+public:
+  splay_node node;
+  uint64_t key;
+};
+
+// the difference of two uint64_t keys does not fit the int result
+template <>
+inline int compare<kv_node_u64, struct splay_node>(struct splay_node *lhs, struct splay_node *rhs) {
+  uint64_t a = _get_entry(lhs, kv_node_u64, node)->key, b = _get_entry(rhs, kv_node_u64, node)->key;
+  return (a > b) - (a < b);
+}
+
+static void BM_SplayTree_InsertRandomU64Generic(benchmark::State& state) {
+  std::vector<kv_node_u64> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    struct splay_tree tree;
+    splay_tree_init(&tree);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx];
+      splay_insert(&tree, &data[idx].node, compare<kv_node_u64, struct splay_node>);
+    }
+  }
+}
+
+static void BM_SplayTreeU64_InsertRandom(benchmark::State& state) {
+  std::vector<splay_node_u64> data(NUMBER_ELEMENTS);
+
+  for (auto _ : state) {
+    struct splay_tree_u64 tree;
+    splay_tree_u64_init(&tree);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx];
+      splay_u64_insert(&tree, &data[idx]);
+    }
+  }
+}
+
+static void BM_SplayTree_SearchRandomlyU64Generic(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node_u64> data(count);
+
+  splay_tree_init(&tree);
+
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node_u64, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_u64 query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = (uint64_t) values[idx] * count / (2 * NUMBER_ELEMENTS);
+      auto cur = splay_search(&tree, &query.node, compare<kv_node_u64, struct splay_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+static void BM_SplayTreeU64_SearchRandomly(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree_u64 tree;
+  std::vector<splay_node_u64> data(count);
+
+  splay_tree_u64_init(&tree);
+
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_u64_insert(&tree, &data[idx]);
+  }
+
+  for (auto _ : state) {
+    splay_node_u64 query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = (uint64_t) values[idx] * count / (2 * NUMBER_ELEMENTS);
+      auto cur = splay_u64_search(&tree, &query);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+// byte-string keys out of line: the generic tree runs memcmp on every step, the prefix tree
+// only on equal 8-byte prefixes. state.range(0) picks URL-like (0) or UUID-like (1) keys.
+class str_node {
+public:
+  splay_node node;
+  const std::string *key;
+};
+
+class str_node_prefix {
+public:
+  splay_node_u64 node;
+  const std::string *key;
+};
+
+int compare_str(splay_node *lhs, splay_node *rhs) {
+  return _get_entry(lhs, str_node, node)->key->compare(*_get_entry(rhs, str_node, node)->key);
+}
+
+int compare_str_prefix(splay_node_u64 *lhs, splay_node_u64 *rhs) {
+  return _get_entry(lhs, str_node_prefix, node)->key->compare(*_get_entry(rhs, str_node_prefix, node)->key);
+}
+
+std::vector<std::string> make_string_keys(int kind, int count) {
+  static const char hex[] = "0123456789abcdef";
+  std::minstd_rand rng(kind + 1);
+  std::vector<std::string> keys(count);
+  for(int idx = 0; idx < count; idx ++) {
+    std::string &key = keys[idx];
+    if (kind == 0) {
+      // host/path/id with the scheme stripped, as URL indexes usually store them
+      for(int len = 3 + rng() % 10; len > 0; len --) key += (char) ('a' + rng() % 26);
+      key += ".com/";
+      for(int len = 4 + rng() % 16; len > 0; len --) key += (char) ('a' + rng() % 26);
+      key += "/" + std::to_string(idx);
+    } else {
+      for(int pos = 0; pos < 36; pos ++) {
+        key += (pos == 8 || pos == 13 || pos == 18 || pos == 23) ? '-' : hex[rng() % 16];
+      }
+    }
+  }
+  return keys;
+}
+
+static void BM_SplayTree_SearchStrings(benchmark::State& state) {
+  std::vector<std::string> keys = make_string_keys(state.range(0), NUMBER_ELEMENTS);
+  std::vector<str_node> data(NUMBER_ELEMENTS);
+  struct splay_tree tree;
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = &keys[idx];
+    splay_insert(&tree, &data[idx].node, compare_str);
+  }
+
+  for (auto _ : state) {
+    str_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = &keys[values[idx] % NUMBER_ELEMENTS];
+      auto cur = splay_search(&tree, &query.node, compare_str);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+static void BM_SplayTreePrefix_SearchStrings(benchmark::State& state) {
+  std::vector<std::string> keys = make_string_keys(state.range(0), NUMBER_ELEMENTS);
+  std::vector<str_node_prefix> data(NUMBER_ELEMENTS);
+  struct splay_tree_u64 tree;
+
+  splay_tree_u64_init_prefix(&tree, compare_str_prefix);
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = &keys[idx];
+    data[idx].node.key = splay_key_prefix(keys[idx].data(), keys[idx].size());
+    splay_u64_insert(&tree, &data[idx].node);
+  }
+
+  for (auto _ : state) {
+    str_node_prefix query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = &keys[values[idx] % NUMBER_ELEMENTS];
+      query.node.key = splay_key_prefix(query.key->data(), query.key->size());
+      auto cur = splay_u64_search(&tree, &query.node);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+// skewed workloads: Zipf-distributed ranks (s = 0.99) mapped onto shuffled keys 1..count
+std::vector<uint64_t> make_zipf_keys(int count, int samples, double skew = 0.99) {
+  std::vector<double> cdf(count);
+  double sum = 0;
+  for(int rank = 0; rank < count; rank ++) {
+    sum += 1.0 / std::pow(rank + 1, skew);
+    cdf[rank] = sum;
+  }
+
+  std::vector<uint64_t> keyOfRank(count);
+  for(int rank = 0; rank < count; rank ++) keyOfRank[rank] = rank + 1;
+  std::minstd_rand rng(count);
+  std::shuffle(keyOfRank.begin(), keyOfRank.end(), rng);
+
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<uint64_t> keys(samples);
+  for(int idx = 0; idx < samples; idx ++) {
+    int rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+    keys[idx] = keyOfRank[std::min(rank, count - 1)];
+  }
+  return keys;
+}
+
+// state.range(0): 0 for uniform, 1 for Zipf lookups
+std::vector<uint64_t> make_workload_keys(int kind, int count, int samples) {
+  if (kind) return make_zipf_keys(count, samples);
+
+  std::vector<uint64_t> keys(samples);
+  for(int idx = 0; idx < samples; idx ++) {
+    keys[idx] = (uint64_t) values[idx % NUMBER_ELEMENTS] * count / (2 * NUMBER_ELEMENTS) + 1;
+  }
+  return keys;
+}
+
+static void BM_SplayBlock_InsertRandom(benchmark::State& state) {
+  for (auto _ : state) {
+    struct splay_block_tree tree;
+    splay_block_tree_init(&tree);
+
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      splay_block_insert(&tree, values[idx]);
+    }
+
+    state.PauseTiming();
+    splay_block_tree_free(&tree);
+    state.ResumeTiming();
+  }
+}
+
+static void BM_SplayTreeU64_SearchWorkload(benchmark::State& state) {
+  int count = state.range(1);
+  struct splay_tree_u64 tree;
+  std::vector<splay_node_u64> data(count);
+  std::vector<uint64_t> queries = make_workload_keys(state.range(0), count, NUMBER_ELEMENTS);
+
+  splay_tree_u64_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_u64_insert(&tree, &data[idx]);
+  }
+
+  for (auto _ : state) {
+    splay_node_u64 query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = queries[idx];
+      auto cur = splay_u64_search(&tree, &query);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+static void BM_SplayBlock_SearchWorkload(benchmark::State& state) {
+  int count = state.range(1);
+  struct splay_block_tree tree;
+  std::vector<uint64_t> queries = make_workload_keys(state.range(0), count, NUMBER_ELEMENTS);
+
+  splay_block_tree_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    splay_block_insert(&tree, idx + 1);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      bool found = splay_block_search(&tree, queries[idx]);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  splay_block_tree_free(&tree);
+}
+
+// lower bound kernels alone (state.range(0) is the SIMD level, state.range(1) the block size)
+// and inside the block tree search path
+static void BM_LowerBoundU64(benchmark::State& state) {
+  if (splay_simd_select((splay_simd_level) state.range(0)) != state.range(0)) {
+    state.SkipWithError("SIMD level not supported");
+    return;
+  }
+  uint32_t count = state.range(1);
+  std::vector<uint64_t> keys(count);
+  for(uint32_t idx = 0; idx < count; idx ++) keys[idx] = 2 * idx + 1;
+
+  uint32_t sum = 0;
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      sum += splay_lower_bound_u64(keys.data(), count, values[idx] % (2 * count));
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  splay_simd_select(SPLAY_SIMD_AVX2);
+}
+
+static void BM_LowerBoundU32(benchmark::State& state) {
+  if (splay_simd_select((splay_simd_level) state.range(0)) != state.range(0)) {
+    state.SkipWithError("SIMD level not supported");
+    return;
+  }
+  uint32_t count = state.range(1);
+  std::vector<uint32_t> keys(count);
+  for(uint32_t idx = 0; idx < count; idx ++) keys[idx] = 2 * idx + 1;
+
+  uint32_t sum = 0;
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      sum += splay_lower_bound_u32(keys.data(), count, values[idx] % (2 * count));
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  splay_simd_select(SPLAY_SIMD_AVX2);
+}
+
+static void BM_SplayBlock_SearchSimd(benchmark::State& state) {
+  if (splay_simd_select((splay_simd_level) state.range(0)) != state.range(0)) {
+    state.SkipWithError("SIMD level not supported");
+    return;
+  }
+  struct splay_block_tree tree;
+  splay_block_tree_init(&tree);
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    splay_block_insert(&tree, idx + 1);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      bool found = splay_block_search(&tree, values[idx]);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  splay_block_tree_free(&tree);
+  splay_simd_select(SPLAY_SIMD_AVX2);
+}
+
+// many tiny trees (state.range(0) nodes each), build with -D_SPLAY_SMALL_TREE to compare
+// the inline sorted array against plain splay trees
+static void BM_SplayTree_ManyTinyTrees(benchmark::State& state) {
+  int size = state.range(0), trees = NUMBER_ELEMENTS / size;
+  std::vector<struct splay_tree> tree(trees);
+  std::vector<kv_node> data(trees * size);
+
+  for(int idx = 0; idx < trees; idx ++) {
+    splay_tree_init(&tree[idx]);
+  }
+  for(int idx = 0; idx < trees * size; idx ++) {
+    data[idx].key = values[idx] % (4 * size);
+    splay_insert(&tree[idx % trees], &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx] % (4 * size);
+      auto cur = splay_search(&tree[(idx * 7919) % trees], &query.node, compare<kv_node, struct splay_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+// high-duplicate workload, state.range(0) distinct keys shared by NUMBER_ELEMENTS nodes
+static void BM_SplayTree_MultisetInsert(benchmark::State& state) {
+  int distinct = state.range(0);
+  std::vector<kv_node> data(NUMBER_ELEMENTS);
+  for (auto _ : state) {
+    struct splay_tree tree;
+    splay_tree_init(&tree);
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      data[idx].key = values[idx] % distinct;
+      splay_insert_multi(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+    }
+  }
+}
+
+static void BM_SplayTree_MultisetEqualRange(benchmark::State& state) {
+  int distinct = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node> data(NUMBER_ELEMENTS);
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    data[idx].key = values[idx] % distinct;
+    splay_insert_multi(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node query;
+    splay_node *end;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = values[idx] % distinct;
+      auto cur = splay_equal_range(&tree, &query.node, compare<kv_node, struct splay_node>, &end);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+}
+#endif
+
+static void BM_STLMultiset_Insert(benchmark::State& state) {
+  int distinct = state.range(0);
+  for (auto _ : state) {
+    std::multiset<int> set;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      set.insert(values[idx] % distinct);
+    }
+  }
+}
+
+static void BM_STLMultiset_EqualRange(benchmark::State& state) {
+  int distinct = state.range(0);
+  std::multiset<int> set;
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    set.insert(values[idx] % distinct);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      auto range = set.equal_range(values[idx] % distinct);
+      benchmark::DoNotOptimize(range);
+    }
+  }
+}
+
+// hot/cold split: links and key in one array, the sibling chain in another, at 10M+ nodes
+static void BM_SplayArena_SearchRandomly(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_arena arena;
+  if (splay_arena_init(&arena, count + 1) < 0) {
+    state.SkipWithError("out of memory");
+    return;
+  }
+  for(int idx = 0; idx < count; idx ++) {
+    splay_arena_insert(&arena, idx + 1);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      auto id = splay_arena_search(&arena, (uint64_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+      benchmark::DoNotOptimize(id);
+    }
+  }
+  state.counters["bytes_per_node"] = sizeof(struct splay_arena_link) + sizeof(struct splay_arena_sibling);
+  splay_arena_free(&arena);
+}
+
+static void BM_SplayArena_LoopSequentially(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_arena arena;
+  if (splay_arena_init(&arena, count + 1) < 0) {
+    state.SkipWithError("out of memory");
+    return;
+  }
+  for(int idx = 0; idx < count; idx ++) {
+    splay_arena_insert(&arena, idx + 1);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for(uint32_t id = splay_arena_first(&arena); id; id = splay_arena_next(&arena, id)) {
+      sum += splay_arena_key(&arena, id);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  splay_arena_free(&arena);
+}
+
+// node storage: state.range(0) is -1 for one malloc per node, 0 for a pool on base pages and
+// 1 for a pool asking for huge pages; the backing it got is reported, see dtlb_misses
+static void BM_SplayTree_SearchPool(benchmark::State& state) {
+  int count = state.range(1);
+  struct splay_tree tree;
+  struct splay_pool pool;
+  std::vector<kv_node*> nodes(count);
+
+  bool pooled = state.range(0) >= 0;
+  if (pooled && splay_pool_init(&pool, sizeof(kv_node), count, -1, state.range(0) ? SPLAY_POOL_HUGE : 0) < 0) {
+    state.SkipWithError("mmap failed");
+    return;
+  }
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    nodes[idx] = pooled ? (kv_node *) splay_pool_alloc(&pool) : new kv_node;
+  }
+  // insert in random order, so that neighbours in the tree are far apart in memory
+  std::shuffle(nodes.begin(), nodes.end(), std::default_random_engine(7));
+  for(int idx = 0; idx < count; idx ++) {
+    nodes[idx]->key = idx + 1;
+    splay_insert(&tree, &nodes[idx]->node, compare<kv_node, struct splay_node>);
+  }
+
+  PerfCounters perf;
+  perf.start();
+  for (auto _ : state) {
+    kv_node query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = (int) ((int64_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+      auto cur = splay_search(&tree, &query.node, compare<kv_node, struct splay_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  perf.report(state, NUMBER_ELEMENTS);
+
+  if (pooled) {
+    state.counters["backing"] = pool.backing;
+    splay_pool_destroy(&pool);
+  } else {
+    for(auto node : nodes) delete node;
+  }
+}
+
+static size_t checkpoint_save(splay_node *node, void *buf, size_t len, void *arg) {
+  if (len >= sizeof(int)) memcpy(buf, &_get_entry(node, kv_node, node)->key, sizeof(int));
+  return sizeof(int);
+}
+
+static splay_node *checkpoint_load(const void *record, size_t len, void *arg) {
+  kv_node *data = (*(kv_node **) arg) ++;
+  memcpy(&data->key, record, sizeof(int));
+  return &data->node;
+}
+
+static void BM_SplayTree_Checkpoint(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node> data(count);
+  FILE *file = tmpfile();
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ftruncate(fileno(file), 0);
+    lseek(fileno(file), 0, SEEK_SET);
+    state.ResumeTiming();
+    splay_checkpoint(&tree, compare<kv_node, struct splay_node>, fileno(file), sizeof(int), checkpoint_save, NULL);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * sizeof(int));
+  fclose(file);
+}
+
+static void BM_SplayTree_Restore(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node> data(count);
+  FILE *file = tmpfile();
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx + 1;
+    splay_insert(&tree, &data[idx].node, compare<kv_node, struct splay_node>);
+  }
+  splay_checkpoint(&tree, compare<kv_node, struct splay_node>, fileno(file), sizeof(int), checkpoint_save, NULL);
+
+  for (auto _ : state) {
+    kv_node *next = data.data();
+    splay_tree_init(&tree);
+    splay_restore(&tree, fileno(file), checkpoint_load, &next);
+    benchmark::DoNotOptimize(tree.root);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * sizeof(int));
+  fclose(file);
+}
+
+class kv_node_rel {
+public:
+  splay_rel_node node;
+  int key;
+};
+
+static void BM_SplayRel_SearchRandomly(benchmark::State& state) {
+  int count = state.range(0);
+  struct splay_rel rel;
+  // the allocator rounds every object up to 16 bytes
+  size_t size = 64 + (size_t) count * ((sizeof(kv_node_rel) + 15) & ~15);
+  void *base = malloc(size);
+  if (!base || splay_rel_init(&rel, base, size) < 0) {
+    state.SkipWithError("out of memory");
+    return;
+  }
+  for(int idx = 0; idx < count; idx ++) {
+    kv_node_rel *data = (kv_node_rel *) splay_rel_alloc(&rel, sizeof(kv_node_rel));
+    data->key = idx + 1;
+    splay_rel_insert(&rel, &data->node, compare<kv_node_rel, struct splay_rel_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_rel query;
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      query.key = (int) ((int64_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+      auto cur = splay_rel_search(&rel, &query.node, compare<kv_node_rel, struct splay_rel_node>);
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  free(base);
+}
+
+class kv_node_sum {
+public:
+  splay_node node;
+  int key;
+  int64_t sum;
+};
+
+// sum of the keys in [lo, lo + k), by walking
+static void BM_SplayTree_RangeSumWalk(benchmark::State& state) {
+  int count = 1 << 20, k = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node_sum> data(count);
+
+  splay_tree_init(&tree);
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx;
+    splay_insert(&tree, &data[idx].node, compare<kv_node_sum, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_sum query;
+    for(int idx = 0; idx < 1000; idx ++) {
+      query.key = values[idx] % (count - k);
+      int64_t sum = 0;
+      auto cur = splay_search(&tree, &query.node, compare<kv_node_sum, struct splay_node>);
+      for(int step = 0; step < k && cur; step ++) {
+        sum += _get_entry(cur, kv_node_sum, node)->key;
+        cur = splay_next(&tree, cur, compare<kv_node_sum, struct splay_node>);
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+#ifdef _SPLAY_AUGMENT
+
+static void sum_update(splay_node *node) {
+  kv_node_sum *cur = _get_entry(node, kv_node_sum, node);
+  cur->sum = cur->key;
+  if (splay_left(node)) cur->sum += _get_entry(splay_left(node), kv_node_sum, node)->sum;
+  if (splay_right(node)) cur->sum += _get_entry(splay_right(node), kv_node_sum, node)->sum;
+}
+
+static void sum_visit(splay_node *node, bool subtree, void *arg) {
+  kv_node_sum *cur = _get_entry(node, kv_node_sum, node);
+  *(int64_t *) arg += subtree ? cur->sum : cur->key;
+}
+
+static void BM_SplayTree_RangeSumAugmented(benchmark::State& state) {
+  int count = 1 << 20, k = state.range(0);
+  struct splay_tree tree;
+  std::vector<kv_node_sum> data(count);
+
+  splay_tree_init_augmented(&tree, sum_update);
+  for(int idx = 0; idx < count; idx ++) {
+    data[idx].key = idx;
+    splay_insert(&tree, &data[idx].node, compare<kv_node_sum, struct splay_node>);
+  }
+
+  for (auto _ : state) {
+    kv_node_sum lo, hi;
+    for(int idx = 0; idx < 1000; idx ++) {
+      lo.key = values[idx] % (count - k);
+      hi.key = lo.key + k - 1;
+      int64_t sum = 0;
+      splay_range_aggregate(&tree, &lo.node, &hi.node, compare<kv_node_sum, struct splay_node>, sum_visit, &sum);
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+#endif
+
+#ifdef _SPLAY_AUGMENT
+
+static bool count_interval(splay_interval *interval, void *arg) {
+  (*(size_t *) arg) ++;
+  return true;
+}
+
+// count reservations of up to 1000 units over [0, count * 100), then 100 point queries
+static void make_intervals(std::vector<splay_interval>& intervals, struct splay_tree *tree) {
+  std::default_random_engine rng(11);
+  splay_interval_init(tree);
+  for(auto& interval : intervals) {
+    interval.start = rng() % (intervals.size() * 100);
+    interval.end = interval.start + 1 + rng() % 1000;
+    splay_interval_insert(tree, &interval);
+  }
+}
+
+static void BM_SplayInterval_Overlap(benchmark::State& state) {
+  std::vector<splay_interval> intervals(state.range(0));
+  struct splay_tree tree;
+  make_intervals(intervals, &tree);
+
+  size_t found = 0;
+  for (auto _ : state) {
+    for(int idx = 0; idx < 100; idx ++) {
+      uint64_t point = (uint64_t) values[idx] * intervals.size() * 50 / NUMBER_ELEMENTS;
+      splay_interval_overlap(&tree, point, point + 1, count_interval, &found);
+    }
+  }
+  state.counters["found"] = (double) found / state.iterations() / 100;
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+
+static void BM_SplayInterval_ScanChain(benchmark::State& state) {
+  std::vector<splay_interval> intervals(state.range(0));
+  struct splay_tree tree;
+  make_intervals(intervals, &tree);
+
+  size_t found = 0;
+  for (auto _ : state) {
+    for(int idx = 0; idx < 100; idx ++) {
+      uint64_t point = (uint64_t) values[idx] * intervals.size() * 50 / NUMBER_ELEMENTS;
+      for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, NULL)) {
+        splay_interval *interval = _get_entry(cur, splay_interval, node);
+        if (interval->start > point) break;
+        if (interval->end > point) found ++;
+      }
+    }
+  }
+  state.counters["found"] = (double) found / state.iterations() / 100;
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+
+#endif
+
+class seq_node {
+public:
+  splay_seq_node node;
+  int value;
+};
+
+// 1000 inserts at random positions, then 1000 erases, on a sequence of count elements
+static void BM_SplaySeq_InsertMiddle(benchmark::State& state) {
+  size_t count = state.range(0);
+  std::vector<seq_node> nodes(count + 1000);
+  std::vector<splay_seq_node *> spare(1000);
+  struct splay_seq seq;
+  splay_seq_init(&seq);
+  for(size_t idx = 0; idx < count; idx ++) {
+    splay_seq_insert(&seq, idx, &nodes[idx].node);
+  }
+  // appending leaves a path, let the splays shorten it before timing
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    splay_seq_at(&seq, (size_t) generator() % count);
+  }
+  for(int idx = 0; idx < 1000; idx ++) {
+    spare[idx] = &nodes[count + idx].node;
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < 1000; idx ++) {
+      splay_seq_insert(&seq, (size_t) values[idx] * count / (2 * NUMBER_ELEMENTS), spare[idx]);
+    }
+    for(int idx = 0; idx < 1000; idx ++) {
+      spare[idx] = splay_seq_erase(&seq, (size_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2000);
+}
+
+static void BM_Vector_InsertMiddle(benchmark::State& state) {
+  size_t count = state.range(0);
+  std::vector<seq_node *> seq(count);
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < 1000; idx ++) {
+      seq.insert(seq.begin() + (size_t) values[idx] * count / (2 * NUMBER_ELEMENTS), nullptr);
+    }
+    for(int idx = 0; idx < 1000; idx ++) {
+      seq.erase(seq.begin() + (size_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2000);
+}
+
+static void BM_SplaySeq_RandomAccess(benchmark::State& state) {
+  size_t count = state.range(0);
+  std::vector<seq_node> nodes(count);
+  struct splay_seq seq;
+  splay_seq_init(&seq);
+  for(size_t idx = 0; idx < count; idx ++) {
+    splay_seq_insert(&seq, idx, &nodes[idx].node);
+  }
+  // appending leaves a path, let the splays shorten it before timing
+  for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+    splay_seq_at(&seq, (size_t) generator() % count);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      auto cur = splay_seq_at(&seq, (size_t) values[idx] * count / (2 * NUMBER_ELEMENTS));
+      benchmark::DoNotOptimize(cur);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUMBER_ELEMENTS);
+}
+
+class cache_node {
+public:
+  splay_cache_entry entry;
+  int key;
+};
+
+int compare_cache(splay_node *lhs, splay_node *rhs) {
+  return _get_entry(lhs, cache_node, entry.node)->key - _get_entry(rhs, cache_node, entry.node)->key;
+}
+
+// requests over 1M keys with P(rank k) ~ 1 / k^0.99, ranks scattered over the key space
+std::vector<int> zipf_trace(size_t count) {
+  const int keys = 1 << 20;
+  std::vector<double> cdf(keys);
+  double sum = 0;
+  for(int k = 0; k < keys; k ++) {
+    sum += 1.0 / std::pow(k + 1, 0.99);
+    cdf[k] = sum;
+  }
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<int> trace(count);
+  for(auto &key : trace) {
+    int rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+    key = (int) (((uint32_t) rank * 2654435761u) & (keys - 1));
+  }
+  return trace;
+}
+
+const std::vector<int>& zipf_requests() {
+  static std::vector<int> trace = zipf_trace(1 << 20);
+  return trace;
+}
+
+void recycle_cache_entry(splay_cache_entry *entry, void *arg) {
+  ((std::vector<cache_node *> *) arg)->push_back(_get_entry(entry, cache_node, entry));
+}
+
+static void BM_SplayCache_Zipf(benchmark::State& state) {
+  auto &trace = zipf_requests();
+  size_t capacity = state.range(1);
+  std::vector<cache_node> nodes(capacity + 1);
+  std::vector<cache_node *> spare;
+  for(auto &node : nodes) {
+    spare.push_back(&node);
+  }
+  struct splay_cache cache;
+  splay_cache_init(&cache, compare_cache, (splay_cache_policy) state.range(0), capacity, 0, recycle_cache_entry, &spare);
+  cache_node query;
+  size_t hits = 0;
+
+  for (auto _ : state) {
+    for(int key : trace) {
+      query.key = key;
+      if (splay_cache_get(&cache, &query.entry.node)) {
+        hits ++;
+        continue;
+      }
+      auto node = spare.back();
+      spare.pop_back();
+      node->key = key;
+      node->entry.charge = 1;
+      splay_cache_put(&cache, &node->entry);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * trace.size());
+  state.counters["hit_rate"] = (double) hits / (state.iterations() * trace.size());
+}
+
+// the usual LRU: hash map from key to a position in a recency list
+static void BM_LRUHashMap_Zipf(benchmark::State& state) {
+  auto &trace = zipf_requests();
+  size_t capacity = state.range(0);
+  std::list<int> order;
+  std::unordered_map<int, std::list<int>::iterator> map;
+  map.reserve(capacity + 1);
+  size_t hits = 0;
+
+  for (auto _ : state) {
+    for(int key : trace) {
+      auto it = map.find(key);
+      if (it != map.end()) {
+        order.splice(order.begin(), order, it->second);
+        hits ++;
+        continue;
+      }
+      order.push_front(key);
+      map.emplace(key, order.begin());
+      if (map.size() > capacity) {
+        map.erase(order.back());
+        order.pop_back();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * trace.size());
+  state.counters["hit_rate"] = (double) hits / (state.iterations() * trace.size());
+}
+
+// an unsorted dump with some keys repeated, loaded one insert at a time or in bulk
+std::vector<kv_node> unsorted_dump(size_t count) {
+  std::vector<kv_node> nodes(count);
+  std::mt19937 rng(3);
+  for(auto &node : nodes) {
+    node.key = rng() % (count + count / 8);
+  }
+  return nodes;
+}
+
+static void BM_SplayTree_LoadUnsorted(benchmark::State& state) {
+  auto nodes = unsorted_dump(state.range(0));
+  for (auto _ : state) {
+    struct splay_tree tree;
+    splay_tree_init(&tree);
+    for(auto &node : nodes) {
+      splay_insert(&tree, &node.node, compare<kv_node, struct splay_node>);
+    }
+    benchmark::DoNotOptimize(tree.root);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SplayTree_BuildParallel(benchmark::State& state) {
+  auto nodes = unsorted_dump(state.range(0));
+  std::vector<splay_node *> input(nodes.size()), pointers(nodes.size());
+  for(size_t idx = 0; idx < nodes.size(); idx ++) {
+    input[idx] = &nodes[idx].node;
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    pointers = input;
+    state.ResumeTiming();
+    struct splay_tree tree;
+    size_t unique;
+    splay_tree_init(&tree);
+    splay_build_parallel(&tree, pointers.data(), pointers.size(), compare<kv_node, struct splay_node>, state.range(1), &unique);
+    benchmark::DoNotOptimize(tree.root);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+// two sets of random keys out of [0, 4 * size of the bigger one)
+struct set_pair {
+  std::vector<kv_node> a, b;
+  splay_tree treeA, treeB;
+  std::set<int> setA, setB;
+
+  set_pair(size_t countA, size_t countB) : a(countA), b(countB) {
+    std::mt19937 rng(5);
+    size_t range = 4 * std::max(countA, countB);
+    splay_tree_init(&treeA);
+    splay_tree_init(&treeB);
+    for(auto &node : a) {
+      node.key = rng() % range;
+      if (setA.insert(node.key).second) splay_insert(&treeA, &node.node, compare<kv_node, struct splay_node>);
+    }
+    for(auto &node : b) {
+      node.key = rng() % range;
+      if (setB.insert(node.key).second) splay_insert(&treeB, &node.node, compare<kv_node, struct splay_node>);
+    }
+  }
+};
+
+void collect_key(splay_node *node, void *arg) {
+  ((std::vector<int> *) arg)->push_back(_get_entry(node, kv_node, node)->key);
+}
+
+static void BM_SplaySet_Intersect(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    splay_set_visit(&sets.treeA, &sets.treeB, compare<kv_node, struct splay_node>, SPLAY_SET_INTERSECTION, collect_key, &out);
+  }
+  state.counters["result"] = out.size();
+}
+
+// walk the first tree and look every node up in the second
+static void BM_SplaySet_IntersectBySearch(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    for(auto cur = splay_first(&sets.treeA); cur; cur = splay_next(&sets.treeA, cur, compare<kv_node, struct splay_node>)) {
+      if (splay_search(&sets.treeB, cur, compare<kv_node, struct splay_node>)) {
+        out.push_back(_get_entry(cur, kv_node, node)->key);
+      }
+    }
+  }
+  state.counters["result"] = out.size();
+}
+
+static void BM_STLSet_Intersect(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    std::set_intersection(sets.setA.begin(), sets.setA.end(), sets.setB.begin(), sets.setB.end(), std::back_inserter(out));
+  }
+  state.counters["result"] = out.size();
+}
+
+static void BM_SplaySet_Union(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    splay_set_visit(&sets.treeA, &sets.treeB, compare<kv_node, struct splay_node>, SPLAY_SET_UNION, collect_key, &out);
+  }
+  state.counters["result"] = out.size();
+}
+
+static void BM_STLSet_Union(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    std::set_union(sets.setA.begin(), sets.setA.end(), sets.setB.begin(), sets.setB.end(), std::back_inserter(out));
+  }
+  state.counters["result"] = out.size();
+}
+
+// removes the keys of the small set and puts them back, so every iteration starts the same
+static void BM_SplaySet_SubtractSmall(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  std::vector<splay_node *> removed;
+  for (auto _ : state) {
+    removed.clear();
+    splay_set_subtract(&sets.treeA, &sets.treeB, compare<kv_node, struct splay_node>,
+                       [](splay_node *node, void *arg) { ((std::vector<splay_node *> *) arg)->push_back(node); }, &removed);
+    state.PauseTiming();
+    for(auto node : removed) {
+      splay_insert(&sets.treeA, node, compare<kv_node, struct splay_node>);
+    }
+    state.ResumeTiming();
+  }
+  state.counters["result"] = removed.size();
+}
+
+static void BM_STLSet_SubtractSmall(benchmark::State& state) {
+  set_pair sets(state.range(0), state.range(1));
+  size_t removed = 0;
+  for (auto _ : state) {
+    removed = 0;
+    for(int key : sets.setB) {
+      removed += sets.setA.erase(key);
+    }
+    state.PauseTiming();
+    for(int key : sets.setB) {
+      sets.setA.insert(key);
+    }
+    state.ResumeTiming();
+  }
+  state.counters["result"] = removed;
+}
+
+#endif
+
+#ifdef _SPLAY_SIBLING_POINTER
+
+class timer_node {
+public:
+  splay_node node;
+  uint64_t deadline;
+  uint32_t heap_pos, generation;
+};
+
+int compare_timer(splay_node *lhs, splay_node *rhs) {
+  timer_node *a = _get_entry(lhs, timer_node, node), *b = _get_entry(rhs, timer_node, node);
+  if (a->deadline != b->deadline) return a->deadline < b->deadline ? -1 : 1;
+  return (a > b) - (a < b);
+}
+
+// the usual handle-based timer heap: an array heap where every timer knows its slot
+class timer_heap {
+public:
+  std::vector<timer_node *> heap;
+
+  void push(timer_node *timer) {
+    timer->heap_pos = heap.size();
+    heap.push_back(timer);
+    up(timer->heap_pos);
+  }
+
+  timer_node *pop() {
+    timer_node *top = heap[0];
+    remove(top);
+    return top;
+  }
+
+  void remove(timer_node *timer) {
+    uint32_t pos = timer->heap_pos;
+    heap[pos] = heap.back();
+    heap[pos]->heap_pos = pos;
+    heap.pop_back();
+    if (pos < heap.size()) {
+      up(pos);
+      down(heap[pos]->heap_pos);
+    }
+  }
+
+private:
+  void place(uint32_t pos, timer_node *timer) {
+    heap[pos] = timer;
+    timer->heap_pos = pos;
+  }
+
+  void up(uint32_t pos) {
+    timer_node *timer = heap[pos];
+    while (pos && heap[(pos - 1) / 2]->deadline > timer->deadline) {
+      place(pos, heap[(pos - 1) / 2]);
+      pos = (pos - 1) / 2;
+    }
+    place(pos, timer);
+  }
+
+  void down(uint32_t pos) {
+    timer_node *timer = heap[pos];
+    uint32_t child;
+    while ((child = 2 * pos + 1) < heap.size()) {
+      if (child + 1 < heap.size() && heap[child + 1]->deadline < heap[child]->deadline) child ++;
+      if (heap[child]->deadline >= timer->deadline) break;
+      place(pos, heap[child]);
+      pos = child;
+    }
+    place(pos, timer);
+  }
+};
+
+// std::priority_queue cannot cancel, a re-armed timer bumps its generation and the stale
+// entry is skipped when it comes out
+struct timer_entry {
+  uint64_t deadline;
+  uint32_t index, generation;
+  bool operator>(const timer_entry &other) const { return deadline > other.deadline; }
+};
+
+// hold model: pop the earliest timer and schedule it again a random delay later; with
+// state.range(1) every step also re-arms a random timer, as connection timeouts do
+static void BM_SplayPQ_Timers(benchmark::State& state) {
+  size_t count = state.range(0);
+  bool rearm = state.range(1);
+  std::vector<timer_node> timers(count);
+  std::mt19937_64 rng(7);
+  struct splay_pq pq;
+  splay_pq_init(&pq, compare_timer);
+  for(auto &timer : timers) {
+    timer.deadline = rng() % count;
+    splay_pq_push(&pq, &timer.node);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      timer_node *timer = _get_entry(splay_pq_pop_min(&pq), timer_node, node);
+      uint64_t now = timer->deadline;
+      timer->deadline = now + 1 + rng() % count;
+      splay_pq_push(&pq, &timer->node);
+      if (rearm) {
+        timer = &timers[rng() % count];
+        splay_pq_cancel(&pq, &timer->node);
+        timer->deadline = now + 1 + rng() % count;
+        splay_pq_push(&pq, &timer->node);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUMBER_ELEMENTS);
+}
+
+static void BM_BinaryHeap_Timers(benchmark::State& state) {
+  size_t count = state.range(0);
+  bool rearm = state.range(1);
+  std::vector<timer_node> timers(count);
+  std::mt19937_64 rng(7);
+  timer_heap heap;
+  for(auto &timer : timers) {
+    timer.deadline = rng() % count;
+    heap.push(&timer);
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      timer_node *timer = heap.pop();
+      uint64_t now = timer->deadline;
+      timer->deadline = now + 1 + rng() % count;
+      heap.push(timer);
+      if (rearm) {
+        timer = &timers[rng() % count];
+        heap.remove(timer);
+        timer->deadline = now + 1 + rng() % count;
+        heap.push(timer);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUMBER_ELEMENTS);
+}
+
+static void BM_PriorityQueue_Timers(benchmark::State& state) {
+  size_t count = state.range(0);
+  bool rearm = state.range(1);
+  std::vector<timer_node> timers(count);
+  std::mt19937_64 rng(7);
+  std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> queue;
+  for(uint32_t idx = 0; idx < count; idx ++) {
+    timers[idx].deadline = rng() % count;
+    timers[idx].generation = 0;
+    queue.push({timers[idx].deadline, idx, 0});
+  }
+
+  for (auto _ : state) {
+    for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
+      timer_entry top = queue.top();
+      queue.pop();
+      if (top.generation != timers[top.index].generation) {
+        idx --;
+        continue;
+      }
+      timer_node *timer = &timers[top.index];
+      uint64_t now = timer->deadline;
+      timer->deadline = now + 1 + rng() % count;
+      queue.push({timer->deadline, top.index, timer->generation});
+      if (rearm) {
+        uint32_t index = rng() % count;
+        timer = &timers[index];
+        timer->deadline = now + 1 + rng() % count;
+        queue.push({timer->deadline, index, ++ timer->generation});
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUMBER_ELEMENTS);
+}
+
+#endif
+
 BENCHMARK(BM_SplayTree_Append);
 BENCHMARK(BM_AVLTree_Append);
 BENCHMARK(BM_RBTree_Append);
-BENCHMARK(BM_SETSet_Append);
+BENCHMARK_TEMPLATE(BM_STLSet_Append, std::set<int>);
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_Append, splay::set<int>);
+#endif
 BENCHMARK(BM_SplayTree_InsertRandom);
 BENCHMARK(BM_AVLTree_InsertRandom);
 BENCHMARK(BM_RBTree_InsertRandom);
-BENCHMARK(BM_STLSet_InsertRandom);
+BENCHMARK_TEMPLATE(BM_STLSet_InsertRandom, std::set<int>);
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_InsertRandom, splay::set<int>);
+#endif
 BENCHMARK(BM_SplayTree_LoopSequentially);
+#ifdef _SPLAY_XOR_SIBLING
+BENCHMARK(BM_SplayTree_LoopCursor);
+#endif
 BENCHMARK(BM_AVLTree_LoopSequentially);
 BENCHMARK(BM_RBTree_LoopSequentially);
 BENCHMARK(BM_SplayTree_SearchRandomly);
@@ -465,11 +2410,95 @@ BENCHMARK(BM_RBTree_SearchRandomly);
 BENCHMARK(BM_SplayTree_DeleteSequentially)->UseManualTime();
 BENCHMARK(BM_AVLTree_DeleteSequentially)->UseManualTime();
 BENCHMARK(BM_RBTree_DeleteSequentially)->UseManualTime();
-BENCHMARK(BM_STLSet_DeleteSequentially)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_STLSet_DeleteSequentially, std::set<int>)->UseManualTime();
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_DeleteSequentially, splay::set<int>)->UseManualTime();
+#endif
 BENCHMARK(BM_SplayTree_DeleteRandomly)->UseManualTime();
 BENCHMARK(BM_AVLTree_DeleteRandomly)->UseManualTime();
 BENCHMARK(BM_RBTree_DeleteRandomly)->UseManualTime();
-BENCHMARK(BM_STLSet_DeleteRandomly)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_STLSet_DeleteRandomly, std::set<int>)->UseManualTime();
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_DeleteRandomly, splay::set<int>)->UseManualTime();
+#endif
+BENCHMARK(BM_SplayTree_InsertLatency);
+BENCHMARK(BM_AVLTree_InsertLatency);
+BENCHMARK(BM_RBTree_InsertLatency);
+BENCHMARK(BM_SplayTree_SearchLatency);
+BENCHMARK(BM_AVLTree_SearchLatency);
+BENCHMARK(BM_RBTree_SearchLatency);
+BENCHMARK(BM_SplayTree_DeleteLatency)->UseManualTime();
+BENCHMARK(BM_AVLTree_DeleteLatency)->UseManualTime();
+BENCHMARK(BM_RBTree_DeleteLatency)->UseManualTime();
+BENCHMARK(BM_SplayTree_MutexShared)->Arg(100)->Arg(95)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_SplayTree_PerThread)->Arg(100)->Arg(95)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_STLSet_MutexShared, std::set<int>)->Arg(100)->Arg(95)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_MutexShared, splay::set<int>)->Arg(100)->Arg(95)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+#endif
+BENCHMARK(BM_SplayTree_SearchRandomlyLarge)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_SplayTree_FrozenSearchRandomly)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_SplayTree_InsertRandomU64Generic);
+BENCHMARK(BM_SplayTreeU64_InsertRandom);
+BENCHMARK(BM_SplayTree_SearchRandomlyU64Generic)->Arg(NUMBER_ELEMENTS)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_SplayTreeU64_SearchRandomly)->Arg(NUMBER_ELEMENTS)->Arg(1 << 20)->Arg(1 << 22)->Arg(10000000);
+BENCHMARK(BM_SplayTree_SearchStrings)->Arg(0)->Arg(1);
+BENCHMARK(BM_SplayTreePrefix_SearchStrings)->Arg(0)->Arg(1);
+BENCHMARK(BM_SplayBlock_InsertRandom);
+BENCHMARK(BM_SplayTreeU64_SearchWorkload)->ArgsProduct({{0, 1}, {NUMBER_ELEMENTS, 1 << 22}});
+BENCHMARK(BM_SplayBlock_SearchWorkload)->ArgsProduct({{0, 1}, {NUMBER_ELEMENTS, 1 << 22}});
+BENCHMARK(BM_LowerBoundU64)->ArgsProduct({{SPLAY_SIMD_SCALAR, SPLAY_SIMD_SSE42, SPLAY_SIMD_AVX2}, {16, 32, 64}});
+BENCHMARK(BM_LowerBoundU32)->ArgsProduct({{SPLAY_SIMD_SCALAR, SPLAY_SIMD_SSE42, SPLAY_SIMD_AVX2}, {16, 32, 64}});
+BENCHMARK(BM_SplayBlock_SearchSimd)->Arg(SPLAY_SIMD_SCALAR)->Arg(SPLAY_SIMD_SSE42)->Arg(SPLAY_SIMD_AVX2);
+BENCHMARK(BM_SplayTree_ManyTinyTrees)->Arg(4)->Arg(8)->Arg(16);
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+BENCHMARK(BM_SplayTree_MultisetInsert)->Arg(16)->Arg(1000)->Arg(NUMBER_ELEMENTS);
+BENCHMARK(BM_SplayTree_MultisetEqualRange)->Arg(16)->Arg(1000)->Arg(NUMBER_ELEMENTS);
+#endif
+BENCHMARK(BM_STLMultiset_Insert)->Arg(16)->Arg(1000)->Arg(NUMBER_ELEMENTS);
+BENCHMARK(BM_STLMultiset_EqualRange)->Arg(16)->Arg(1000)->Arg(NUMBER_ELEMENTS);
+BENCHMARK(BM_SplayArena_SearchRandomly)->Arg(1 << 20)->Arg(10000000)->Arg(1 << 24);
+BENCHMARK(BM_SplayArena_LoopSequentially)->Arg(1 << 20)->Arg(10000000);
+BENCHMARK(BM_SplayTree_SearchPool)->ArgsProduct({{-1, 0, 1}, {1 << 20, 1 << 23}});
+BENCHMARK(BM_SplayTree_Checkpoint)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_SplayTree_Restore)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_SplayRel_SearchRandomly)->Arg(NUMBER_ELEMENTS)->Arg(1 << 20);
+BENCHMARK(BM_SplayTree_RangeSumWalk)->Arg(16)->Arg(1000)->Arg(100000);
+#ifdef _SPLAY_AUGMENT
+BENCHMARK(BM_SplayTree_RangeSumAugmented)->Arg(16)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_SplayInterval_Overlap)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22);
+#ifdef _SPLAY_SIBLING_POINTER
+BENCHMARK(BM_SplayInterval_ScanChain)->Arg(1 << 16)->Arg(1 << 20);
+#endif
+#endif
+BENCHMARK(BM_SplaySeq_InsertMiddle)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 23);
+BENCHMARK(BM_Vector_InsertMiddle)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_SplaySeq_RandomAccess)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 23);
+BENCHMARK(BM_SplayCache_Zipf)->ArgsProduct({{SPLAY_CACHE_LRU, SPLAY_CACHE_DEEPEST}, {1 << 10, 1 << 14, 1 << 17}});
+BENCHMARK(BM_LRUHashMap_Zipf)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+BENCHMARK(BM_SplayTree_LoadUnsorted)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SplayTree_BuildParallel)->ArgsProduct({{1 << 20, 1 << 23}, {1, 2, 4, 8, 16, 32}})->UseRealTime()->Unit(benchmark::kMillisecond);
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+BENCHMARK(BM_SplaySet_Intersect)->Args({1 << 20, 1 << 20})->Args({1 << 20, 1 << 10})->Args({1 << 10, 1 << 20});
+BENCHMARK(BM_SplaySet_IntersectBySearch)->Args({1 << 20, 1 << 20})->Args({1 << 20, 1 << 10})->Args({1 << 10, 1 << 20});
+BENCHMARK(BM_STLSet_Intersect)->Args({1 << 20, 1 << 20})->Args({1 << 20, 1 << 10})->Args({1 << 10, 1 << 20});
+BENCHMARK(BM_SplaySet_Union)->Args({1 << 20, 1 << 20})->Args({1 << 20, 1 << 10});
+BENCHMARK(BM_STLSet_Union)->Args({1 << 20, 1 << 20})->Args({1 << 20, 1 << 10});
+BENCHMARK(BM_SplaySet_SubtractSmall)->Args({1 << 20, 1 << 10});
+BENCHMARK(BM_STLSet_SubtractSmall)->Args({1 << 20, 1 << 10});
+#endif
+#ifdef _SPLAY_SIBLING_POINTER
+BENCHMARK(BM_SplayPQ_Timers)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1}});
+BENCHMARK(BM_BinaryHeap_Timers)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1}});
+BENCHMARK(BM_PriorityQueue_Timers)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1}});
+#endif
+BENCHMARK(BM_SplayTree_Memory)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Iterations(1);
+BENCHMARK(BM_AVLTree_Memory)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Iterations(1);
+BENCHMARK(BM_RBTree_Memory)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_STLSet_Memory, std::set<int>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Iterations(1);
+#ifdef SPLAY_SET_WRAPPER
+BENCHMARK_TEMPLATE(BM_STLSet_Memory, splay::set<int>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Iterations(1);
+#endif
 
 int main(int argc, char** argv)
 {
@@ -477,6 +2506,7 @@ int main(int argc, char** argv)
   for(int idx = 0; idx < NUMBER_ELEMENTS; idx ++) {
     values[idx] = distribution(generator);
   }
+  calibrate_tsc();
 
   ::benchmark::Initialize(&argc, argv);
   ::benchmark::RunSpecifiedBenchmarks();
@@ -0,0 +1,141 @@
+#ifndef _DUYNGUYEN_PERF_COUNTERS
+#define _DUYNGUYEN_PERF_COUNTERS
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief    Hardware counters read through perf_event_open(2), reported per operation
+ *           as google-benchmark user counters.
+ *
+ * Every event is opened on its own (user-space only, calling thread), so a PMU that lacks
+ * one event or a kernel whose perf_event_paranoid forbids access just drops the affected
+ * counters from the report instead of failing the benchmark.
+ */
+class PerfCounters {
+public:
+  PerfCounters() : running(false) {
+    for(int idx = 0; idx < NUMBER_EVENTS; idx ++) {
+      fds[idx] = open_event(events()[idx].type, events()[idx].config);
+      totals[idx] = 0;
+    }
+  }
+
+  ~PerfCounters() {
+    for(int idx = 0; idx < NUMBER_EVENTS; idx ++) {
+      if (fds[idx] >= 0) close(fds[idx]);
+    }
+  }
+
+  void start() {
+    for(int idx = 0; idx < NUMBER_EVENTS; idx ++) {
+      if (fds[idx] < 0) continue;
+#ifdef __linux__
+      ioctl(fds[idx], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fds[idx], PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    running = true;
+  }
+
+  void stop() {
+    if (!running) return;
+    for(int idx = 0; idx < NUMBER_EVENTS; idx ++) {
+      if (fds[idx] < 0) continue;
+#ifdef __linux__
+      ioctl(fds[idx], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+      totals[idx] += read_scaled(fds[idx]);
+    }
+    running = false;
+  }
+
+  // divide the accumulated counts by (iterations * ops_per_iteration)
+  void report(benchmark::State& state, int64_t ops_per_iteration) {
+    stop();
+    for(int idx = 0; idx < NUMBER_EVENTS; idx ++) {
+      if (fds[idx] < 0) continue;
+      state.counters[events()[idx].name] = benchmark::Counter(
+        (double) totals[idx] / ops_per_iteration, benchmark::Counter::kAvgIterations);
+    }
+  }
+
+private:
+  struct event {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+  };
+
+#ifdef __linux__
+  static const int NUMBER_EVENTS = 6;
+#else
+  static const int NUMBER_EVENTS = 0;
+#endif
+
+  // function-local table so including this header from several translation units stays legal
+  static const event *events() {
+#ifdef __linux__
+#define _PERF_CACHE_EVENT(CACHE, OP, RESULT) \
+  ((CACHE) | ((OP) << 8) | ((RESULT) << 16))
+    static const event table[NUMBER_EVENTS] = {
+      {"instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {"cache_misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {"l1d_misses",    PERF_TYPE_HW_CACHE, _PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D,
+                                                              PERF_COUNT_HW_CACHE_OP_READ,
+                                                              PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {"stores",        PERF_TYPE_HW_CACHE, _PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D,
+                                                              PERF_COUNT_HW_CACHE_OP_WRITE,
+                                                              PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+      {"dtlb_misses",   PERF_TYPE_HW_CACHE, _PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_DTLB,
+                                                              PERF_COUNT_HW_CACHE_OP_READ,
+                                                              PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    };
+#undef _PERF_CACHE_EVENT
+    return table;
+#else
+    return NULL;
+#endif
+  }
+
+  static int open_event(uint32_t type, uint64_t config) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+  }
+
+  // scale by enabled / running time in case the kernel multiplexed the PMU
+  static uint64_t read_scaled(int fd) {
+    uint64_t buf[3];
+    if (read(fd, buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) return 0;
+    if (buf[1] == buf[2]) return buf[0];
+    return (uint64_t) ((double) buf[0] * buf[1] / buf[2]);
+  }
+
+  int fds[NUMBER_EVENTS > 0 ? NUMBER_EVENTS : 1];
+  uint64_t totals[NUMBER_EVENTS > 0 ? NUMBER_EVENTS : 1];
+  bool running;
+};
+
+#endif
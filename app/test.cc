@@ -1,16 +1,49 @@
 #include <unordered_set>
+#include <string>
+#include <vector>
+#include <set>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
 
 #include <gtest/gtest.h>
 
 extern "C" {
 
 #include "splaytree.h"
+#include "splaytree_u64.h"
+#include "splay_block.h"
+#include "splay_arena.h"
+#include "splay_pool.h"
+#include "splay_checkpoint.h"
+#include "splay_rel.h"
+#include "splay_interval.h"
+#include "splay_seq.h"
+#include "splay_cache.h"
+#include "splay_pq.h"
+#include "splay_parallel.h"
+#include "splay_set.h"
+#include "splay_simd.h"
 #include "rbwrap.h"
 
 }
 
+#include "splaytree.hpp"
+
 #define NO_ENTRIES 10000
 
+// while set, malloc fails, to reach the out-of-memory paths
+static bool fail_malloc = false;
+
+extern "C" void *malloc(size_t size) {
+  static void *(*next)(size_t) = (void *(*)(size_t)) dlsym(RTLD_NEXT, "malloc");
+  return fail_malloc ? NULL : next(size);
+}
+
 struct data_node {
 public:
   int key;
@@ -56,7 +89,7 @@ TEST(SplayTree, InsertAndSearch) {
     }
 
     cur = splay_search_lower(&tree, &query.node, compare<data_node, struct splay_node>);
-    if (cur <= 0) {
+    if (!cur) {
       ASSERT_EQ(cur, nullptr);
     } else {
       result = _get_entry(cur, data_node, node);
@@ -152,7 +185,7 @@ TEST(SplayTree, CursorOperator) {
   splay_node *cur = splay_first(&tree);
   data_node *result = _get_entry(cur, data_node, node);
   ASSERT_EQ(cur, tree.root);
-  ASSERT_EQ(cur->left, nullptr);
+  ASSERT_EQ(splay_left(cur), nullptr);
   ASSERT_EQ(result->key, 1);
   for(int i = 2; i <= NO_ENTRIES+1; i ++) {
     cur = splay_next(&tree, cur, compare<data_node, struct splay_node>);
@@ -168,7 +201,7 @@ TEST(SplayTree, CursorOperator) {
   cur = splay_last(&tree);
   result = _get_entry(cur, data_node, node);
   ASSERT_EQ(cur, tree.root);
-  ASSERT_EQ(cur->right, nullptr);
+  ASSERT_EQ(splay_right(cur), nullptr);
   ASSERT_EQ(result->key, NO_ENTRIES);
   for(int i = NO_ENTRIES-1; i >= 0; i --) {
     cur = splay_prev(&tree, cur, compare<data_node, struct splay_node>);
@@ -182,6 +215,1249 @@ TEST(SplayTree, CursorOperator) {
   }
 }
 
+TEST(SplayTree, FreezeAndThaw) {
+  data_node data[NO_ENTRIES];
+  splay_tree tree;
+  splay_frozen frozen;
+  splay_tree_init(&tree);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    data[i].key = i * 2 + 1;
+    splay_insert(&tree, &data[i].node, compare<data_node, struct splay_node>);
+  }
+
+  ASSERT_EQ(splay_freeze(&tree, &frozen), 0);
+  ASSERT_EQ(frozen.count, (size_t) NO_ENTRIES);
+  ASSERT_EQ(tree.root, nullptr);
+
+  data_node query, *result;
+  splay_node *cur;
+  for(int i = 0; i <= 2 * NO_ENTRIES; i ++) {
+    query.key = i;
+    cur = splay_frozen_search(&frozen, &query.node, compare<data_node, struct splay_node>);
+    if (i % 2) {
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, i);
+    } else {
+      ASSERT_EQ(cur, nullptr);
+    }
+
+    cur = splay_frozen_search_lower(&frozen, &query.node, compare<data_node, struct splay_node>);
+    if (i == 0) {
+      ASSERT_EQ(cur, nullptr);
+    } else {
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, (i % 2) ? i : i - 1);
+    }
+
+    cur = splay_frozen_search_greater(&frozen, &query.node, compare<data_node, struct splay_node>);
+    if (i == 2 * NO_ENTRIES) {
+      ASSERT_EQ(cur, nullptr);
+    } else {
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, (i % 2) ? i : i + 1);
+    }
+  }
+
+  splay_thaw(&frozen, &tree);
+  ASSERT_EQ(frozen.nodes, nullptr);
+
+  cur = splay_first(&tree);
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    ASSERT_TRUE(cur != nullptr);
+    result = _get_entry(cur, data_node, node);
+    ASSERT_EQ(result->key, i * 2 + 1);
+    cur = splay_next(&tree, cur, compare<data_node, struct splay_node>);
+  }
+  ASSERT_EQ(cur, nullptr);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    query.key = i * 2 + 1;
+    splay_delete(&tree, &query.node, compare<data_node, struct splay_node>);
+  }
+  ASSERT_EQ(tree.root, nullptr);
+}
+
+TEST(SplayTreeU64, InsertSearchAndRemove) {
+  splay_node_u64 data[NO_ENTRIES];
+  splay_tree_u64 tree;
+  splay_tree_u64_init(&tree);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    data[i].key = i * 2 + 1;
+    splay_u64_insert(&tree, &data[i]);
+  }
+
+  splay_node_u64 query, *cur;
+  for(int i = 0; i <= 2 * NO_ENTRIES; i ++) {
+    query.key = i;
+    cur = splay_u64_search(&tree, &query);
+    if (i % 2) {
+      ASSERT_EQ(cur, tree.root);
+      ASSERT_EQ(cur->key, (uint64_t) i);
+    } else {
+      ASSERT_EQ(cur, nullptr);
+    }
+
+    cur = splay_u64_search_lower(&tree, &query);
+    if (i == 0) {
+      ASSERT_EQ(cur, nullptr);
+    } else {
+      ASSERT_EQ(cur->key, (uint64_t) ((i % 2) ? i : i - 1));
+    }
+
+    cur = splay_u64_search_greater(&tree, &query);
+    if (i == 2 * NO_ENTRIES) {
+      ASSERT_EQ(cur, nullptr);
+    } else {
+      ASSERT_EQ(cur->key, (uint64_t) ((i % 2) ? i : i + 1));
+    }
+  }
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    query.key = (rand() % NO_ENTRIES) * 2 + 1;
+    splay_u64_delete(&tree, &query);
+    ASSERT_EQ(splay_u64_search(&tree, &query), nullptr);
+
+    cur = splay_u64_search_greater(&tree, &query);
+    if (cur) {
+      ASSERT_GT(cur->key, query.key);
+    }
+    cur = splay_u64_search_lower(&tree, &query);
+    if (cur) {
+      ASSERT_LT(cur->key, query.key);
+    }
+  }
+}
+
+TEST(SplayTreeU64, CursorOperator) {
+  splay_node_u64 data[NO_ENTRIES];
+  splay_tree_u64 tree;
+  splay_tree_u64_init(&tree);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    data[i].key = NO_ENTRIES - i;
+    splay_u64_insert(&tree, &data[i]);
+  }
+
+  splay_node_u64 *cur = splay_u64_first(&tree);
+  ASSERT_EQ(cur, tree.root);
+  for(int i = 1; i <= NO_ENTRIES; i ++) {
+    ASSERT_TRUE(cur != nullptr);
+    ASSERT_EQ(cur->key, (uint64_t) i);
+    cur = splay_u64_next(&tree, cur);
+  }
+  ASSERT_EQ(cur, nullptr);
+
+  cur = splay_u64_last(&tree);
+  ASSERT_EQ(cur, tree.root);
+  for(int i = NO_ENTRIES; i >= 1; i --) {
+    ASSERT_TRUE(cur != nullptr);
+    ASSERT_EQ(cur->key, (uint64_t) i);
+    cur = splay_u64_prev(&tree, cur);
+  }
+  ASSERT_EQ(cur, nullptr);
+}
+
+struct string_node {
+  splay_node_u64 node;
+  std::string key;
+};
+
+int compare_string(splay_node_u64 *lhs, splay_node_u64 *rhs) {
+  return _get_entry(lhs, string_node, node)->key.compare(_get_entry(rhs, string_node, node)->key);
+}
+
+TEST(SplayTreeU64, StringPrefix) {
+  std::vector<string_node> data(NO_ENTRIES);
+  std::set<std::string> correct;
+  splay_tree_u64 tree;
+  splay_tree_u64_init_prefix(&tree, compare_string);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    // long shared prefixes, keys that are prefixes of others and embedded zero bytes
+    switch (i % 4) {
+      case 0: data[i].key = "shared/prefix/" + std::to_string(rand() % NO_ENTRIES); break;
+      case 1: data[i].key = std::to_string(rand() % NO_ENTRIES); break;
+      case 2: data[i].key = std::string("ab\0", 3) + std::to_string(rand() % 100); break;
+      default: data[i].key = std::string(rand() % 10, 'a'); break;
+    }
+    data[i].node.key = splay_key_prefix(data[i].key.data(), data[i].key.size());
+    bool fresh = correct.insert(data[i].key).second;
+    splay_u64_insert(&tree, &data[i].node);
+    ASSERT_EQ(splay_u64_search(&tree, &data[i].node) == &data[i].node, fresh);
+  }
+
+  splay_node_u64 *cur = splay_u64_first(&tree);
+  for (const std::string &expected: correct) {
+    ASSERT_TRUE(cur != nullptr);
+    ASSERT_EQ(_get_entry(cur, string_node, node)->key, expected);
+    cur = splay_u64_next(&tree, cur);
+  }
+  ASSERT_EQ(cur, nullptr);
+
+  string_node query;
+  for (const std::string &key: correct) {
+    query.key = key;
+    query.node.key = splay_key_prefix(key.data(), key.size());
+    splay_u64_delete(&tree, &query.node);
+    ASSERT_EQ(splay_u64_search(&tree, &query.node), nullptr);
+  }
+  ASSERT_EQ(tree.root, nullptr);
+}
+
+TEST(SplayBlockTree, RandomOps) {
+  splay_block_tree tree;
+  std::set<uint64_t> correct;
+  splay_block_tree_init(&tree);
+
+  for(int i = 0; i < 20 * NO_ENTRIES; i ++) {
+    uint64_t key = rand() % (2 * NO_ENTRIES);
+    // insert-heavy first half, delete-heavy second half to exercise splits and merges
+    if (rand() % 4 < (i < 10 * NO_ENTRIES ? 3 : 1)) {
+      ASSERT_EQ(splay_block_insert(&tree, key), correct.insert(key).second ? 1 : 0);
+    } else {
+      ASSERT_EQ(splay_block_delete(&tree, key), (int) correct.erase(key));
+    }
+    ASSERT_EQ(tree.count, correct.size());
+  }
+
+  uint64_t result;
+  for(uint64_t key = 0; key <= 2 * NO_ENTRIES; key ++) {
+    ASSERT_EQ(splay_block_search(&tree, key), correct.count(key) == 1);
+
+    auto it = correct.lower_bound(key);
+    ASSERT_EQ(splay_block_search_greater(&tree, key, &result), it != correct.end());
+    if (it != correct.end()) {
+      ASSERT_EQ(result, *it);
+    }
+
+    it = correct.upper_bound(key);
+    ASSERT_EQ(splay_block_search_lower(&tree, key, &result), it != correct.begin());
+    if (it != correct.begin()) {
+      ASSERT_EQ(result, *std::prev(it));
+    }
+  }
+
+  splay_block_tree_free(&tree);
+  ASSERT_EQ(tree.tree.root, nullptr);
+}
+
+TEST(SplayArena, RandomOps) {
+  splay_arena arena;
+  std::set<uint64_t> correct;
+  ASSERT_EQ(splay_arena_init(&arena, 0), 0);
+
+  for(int i = 0; i < 20 * NO_ENTRIES; i ++) {
+    uint64_t key = rand() % (2 * NO_ENTRIES);
+    if (rand() % 4 < (i < 10 * NO_ENTRIES ? 3 : 1)) {
+      uint32_t id = splay_arena_insert(&arena, key);
+      correct.insert(key);
+      ASSERT_NE(id, 0u);
+      ASSERT_EQ(splay_arena_key(&arena, id), key);
+    } else {
+      ASSERT_EQ(splay_arena_delete(&arena, key), correct.erase(key) == 1);
+    }
+    ASSERT_EQ(arena.count, correct.size());
+  }
+
+  for(uint64_t key = 0; key <= 2 * NO_ENTRIES; key ++) {
+    ASSERT_EQ(splay_arena_search(&arena, key) != 0, correct.count(key) == 1);
+
+    auto it = correct.lower_bound(key);
+    uint32_t id = splay_arena_search_greater(&arena, key);
+    ASSERT_EQ(id ? splay_arena_key(&arena, id) : UINT64_MAX, it == correct.end() ? UINT64_MAX : *it);
+
+    it = correct.upper_bound(key);
+    id = splay_arena_search_lower(&arena, key);
+    ASSERT_EQ(id ? splay_arena_key(&arena, id) : UINT64_MAX, it == correct.begin() ? UINT64_MAX : *std::prev(it));
+  }
+
+  std::vector<uint64_t> keys;
+  for(uint32_t id = splay_arena_first(&arena); id; id = splay_arena_next(&arena, id)) {
+    keys.push_back(splay_arena_key(&arena, id));
+  }
+  ASSERT_EQ(keys, std::vector<uint64_t>(correct.begin(), correct.end()));
+  keys.clear();
+  for(uint32_t id = splay_arena_last(&arena); id; id = splay_arena_prev(&arena, id)) {
+    keys.push_back(splay_arena_key(&arena, id));
+  }
+  ASSERT_EQ(keys, std::vector<uint64_t>(correct.rbegin(), correct.rend()));
+
+  splay_arena_free(&arena);
+}
+
+TEST(SplayPool, TreeNodes) {
+  const int n = 10000;
+  splay_pool pool;
+  splay_tree tree;
+  ASSERT_EQ(splay_pool_init(&pool, sizeof(data_node), n, 0, SPLAY_POOL_HUGE), 0);
+  ASSERT_EQ((uintptr_t) pool.base % (2 << 20), 0u);
+  splay_tree_init(&tree);
+
+  for(int i = 0; i < n; i ++) {
+    data_node *data = (data_node *) splay_pool_alloc(&pool);
+    ASSERT_NE(data, nullptr);
+    data->key = i;
+    splay_insert(&tree, &data->node, compare<data_node, struct splay_node>);
+  }
+  ASSERT_EQ(splay_pool_alloc(&pool), nullptr);
+
+  data_node query;
+  for(int i = 0; i < n; i ++) {
+    query.key = i;
+    splay_node *cur = splay_search(&tree, &query.node, compare<data_node, struct splay_node>);
+    ASSERT_NE(cur, nullptr);
+    ASSERT_EQ(_get_entry(cur, data_node, node)->key, i);
+  }
+
+  // released objects come back first
+  query.key = n / 2;
+  data_node *data = _get_entry(splay_search(&tree, &query.node, compare<data_node, struct splay_node>), data_node, node);
+  splay_delete(&tree, &query.node, compare<data_node, struct splay_node>);
+  splay_pool_release(&pool, data);
+  ASSERT_EQ(splay_pool_alloc(&pool), data);
+
+  splay_pool_destroy(&pool);
+}
+
+static size_t save_key(splay_node *node, void *buf, size_t len, void *arg) {
+  int key = _get_entry(node, data_node, node)->key;
+  // length-prefixed records carry the key in decimal
+  size_t need = arg ? std::to_string(key).size() : sizeof(key);
+  if (need <= len) {
+    if (arg) memcpy(buf, std::to_string(key).data(), need);
+    else memcpy(buf, &key, need);
+  }
+  return need;
+}
+
+static splay_node *load_key(const void *record, size_t len, void *arg) {
+  data_node *data = new data_node;
+  if (arg) data->key = std::stoi(std::string((const char *) record, len));
+  else memcpy(&data->key, record, sizeof(data->key));
+  return &data->node;
+}
+
+TEST(SplayTree, CheckpointAndRestore) {
+  const int n = 5000;
+  std::vector<data_node> nodes(n);
+  splay_tree tree;
+  splay_tree_init(&tree);
+  for(int i = 0; i < n; i ++) {
+    nodes[i].key = i * 2 - n;
+    splay_insert(&tree, &nodes[i].node, compare<data_node, struct splay_node>);
+  }
+
+  int text = 1;
+  for(void *arg : {(void *) nullptr, (void *) &text}) {
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(splay_checkpoint(&tree, compare<data_node, struct splay_node>, fileno(file),
+                               arg ? 0 : sizeof(int), save_key, arg), 0);
+
+    splay_tree restored;
+    splay_tree_init(&restored);
+    ASSERT_EQ(splay_restore(&restored, fileno(file), load_key, arg), 0);
+    fclose(file);
+
+    int i = 0;
+    for(splay_node *cur = splay_first(&restored); cur; i ++) {
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, i * 2 - n);
+      cur = splay_next(&restored, cur, compare<data_node, struct splay_node>);
+    }
+    ASSERT_EQ(i, n);
+
+    data_node query;
+    for(i = 0; i < n; i ++) {
+      query.key = i * 2 - n;
+      ASSERT_NE(splay_search(&restored, &query.node, compare<data_node, struct splay_node>), nullptr);
+      query.key ++;
+      ASSERT_EQ(splay_search(&restored, &query.node, compare<data_node, struct splay_node>), nullptr);
+    }
+
+    while (splay_node *cur = splay_first(&restored)) {
+      splay_delete(&restored, cur, compare<data_node, struct splay_node>);
+      delete _get_entry(cur, data_node, node);
+    }
+  }
+}
+
+struct rel_node {
+  splay_rel_node node;
+  int key;
+};
+
+TEST(SplayRel, MapAtTwoAddresses) {
+  const int n = 2000;
+  const size_t size = 1 << 20;
+  FILE *file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(ftruncate(fileno(file), size), 0);
+  char *first = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+  char *second = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+  ASSERT_NE(first, MAP_FAILED);
+  ASSERT_NE(second, MAP_FAILED);
+  ASSERT_NE(first, second);
+
+  splay_rel rel, other;
+  ASSERT_EQ(splay_rel_attach(&rel, first, size), -1);
+  ASSERT_EQ(splay_rel_init(&rel, first, size), 0);
+  for(int i = 0; i < n; i ++) {
+    rel_node *data = (rel_node *) splay_rel_alloc(&rel, sizeof(rel_node));
+    ASSERT_NE(data, nullptr);
+    data->key = (i * 7919) % n * 2;
+    splay_rel_insert(&rel, &data->node, compare<rel_node, splay_rel_node>);
+  }
+
+  // the other mapping sees the same tree, and its updates show in the first one
+  ASSERT_EQ(splay_rel_attach(&other, second, size), 0);
+  ASSERT_EQ(other.header->count, (uint64_t) n);
+  rel_node query;
+  for(int i = 0; i < n; i ++) {
+    query.key = i * 2;
+    ASSERT_NE(splay_rel_find(&other, &query.node, compare<rel_node, splay_rel_node>), nullptr);
+    query.key = i * 2 + 1;
+    auto cur = splay_rel_search_lower(&other, &query.node, compare<rel_node, splay_rel_node>);
+    ASSERT_EQ(_get_entry(cur, rel_node, node)->key, i * 2);
+    ASSERT_GE((char *) cur, second);
+    ASSERT_LT((char *) cur, second + size);
+  }
+  for(int i = 0; i < n; i += 2) {
+    query.key = i * 2;
+    splay_rel_delete(&other, &query.node, compare<rel_node, splay_rel_node>);
+  }
+
+  int i = 1;
+  for(auto cur = splay_rel_first(&rel); cur; cur = splay_rel_next(&rel, cur), i += 2) {
+    ASSERT_EQ(_get_entry(cur, rel_node, node)->key, i * 2);
+    ASSERT_GE((char *) cur, first);
+    ASSERT_LT((char *) cur, first + size);
+  }
+  ASSERT_EQ(i, n + 1);
+  query.key = 0;
+  ASSERT_EQ(splay_rel_search(&rel, &query.node, compare<rel_node, splay_rel_node>), nullptr);
+  query.key = 2;
+  ASSERT_NE(splay_rel_search(&rel, &query.node, compare<rel_node, splay_rel_node>), nullptr);
+
+  munmap(first, size);
+  munmap(second, size);
+  fclose(file);
+}
+
+struct seq_node {
+  splay_seq_node node;
+  int value;
+};
+
+TEST(SplaySeq, PositionalOps) {
+  const int n = 3000;
+  std::vector<seq_node> nodes(n);
+  std::vector<seq_node *> expected;
+  splay_seq seq, right;
+  splay_seq_init(&seq);
+
+  for(int i = 0; i < n; i ++) {
+    nodes[i].value = i;
+    size_t pos = i % 3 ? rand() % (expected.size() + 1) : expected.size();
+    splay_seq_insert(&seq, pos, &nodes[i].node);
+    expected.insert(expected.begin() + pos, &nodes[i]);
+
+    if (i % 5 == 4) {
+      pos = rand() % expected.size();
+      ASSERT_EQ(_get_entry(splay_seq_erase(&seq, pos), seq_node, node), expected[pos]);
+      expected.erase(expected.begin() + pos);
+    }
+    if (i % 100 == 0) {
+      // cut and glue back the other way round
+      pos = rand() % (expected.size() + 1);
+      splay_seq_split(&seq, pos, &right);
+      ASSERT_EQ(splay_seq_size(&seq), pos);
+      ASSERT_EQ(splay_seq_size(&right), expected.size() - pos);
+      splay_seq_concat(&right, &seq);
+      std::swap(seq, right);
+      std::rotate(expected.begin(), expected.begin() + pos, expected.end());
+    }
+    pos = rand() % expected.size();
+    ASSERT_EQ(_get_entry(splay_seq_at(&seq, pos), seq_node, node), expected[pos]);
+  }
+
+  ASSERT_EQ(splay_seq_size(&seq), expected.size());
+  ASSERT_EQ(splay_seq_at(&seq, expected.size()), nullptr);
+  for(size_t i = 0; i < expected.size(); i ++) {
+    ASSERT_EQ(_get_entry(splay_seq_at(&seq, i), seq_node, node), expected[i]);
+  }
+}
+
+TEST(SplayTree, PopFirst) {
+  std::vector<data_node> data(NO_ENTRIES);
+  splay_tree tree;
+  splay_tree_init(&tree);
+  std::set<int> keys;
+
+  // pops interleaved with inserts, so the small array and the tree both get emptied from the front
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    data[i].key = rand();
+    if (keys.insert(data[i].key).second) {
+      splay_insert(&tree, &data[i].node, compare<data_node, struct splay_node>);
+    }
+    if (i % 3 == 2) {
+      splay_node *cur = splay_pop_first(&tree);
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, *keys.begin());
+      keys.erase(keys.begin());
+    }
+  }
+  ASSERT_EQ(_get_entry(splay_first(&tree), data_node, node)->key, *keys.begin());
+  ASSERT_EQ(_get_entry(splay_last(&tree), data_node, node)->key, *keys.rbegin());
+  for(int key : keys) {
+    splay_node *cur = splay_pop_first(&tree);
+    ASSERT_EQ(_get_entry(cur, data_node, node)->key, key);
+  }
+  ASSERT_EQ(splay_pop_first(&tree), nullptr);
+  ASSERT_EQ(splay_first(&tree), nullptr);
+}
+
+#ifdef _SPLAY_SIBLING_POINTER
+
+// deadlines may repeat, the address orders the timers that share one
+static int compare_timer(splay_node *lhs, splay_node *rhs) {
+  data_node *a = _get_entry(lhs, data_node, node), *b = _get_entry(rhs, data_node, node);
+  if (a->key != b->key) return a->key < b->key ? -1 : 1;
+  return (a > b) - (a < b);
+}
+
+TEST(SplayPQ, TimerQueue) {
+  std::vector<data_node> timers(NO_ENTRIES);
+  std::set<std::pair<int, data_node *>> expected;
+  splay_pq pq;
+  splay_pq_init(&pq, compare_timer);
+  ASSERT_EQ(splay_pq_peek_min(&pq), nullptr);
+  ASSERT_EQ(splay_pq_pop_min(&pq), nullptr);
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    timers[i].key = i / 2 + rand() % 100;
+    ASSERT_TRUE(splay_pq_push(&pq, &timers[i].node));
+    expected.insert({timers[i].key, &timers[i]});
+    if (i % 4 == 3) {
+      // cancel one of the recent timers, sometimes the minimum itself
+      data_node *cancel = &timers[i - rand() % 4];
+      if (expected.erase({cancel->key, cancel})) splay_pq_cancel(&pq, &cancel->node);
+    }
+    if (i % 3 == 2) {
+      ASSERT_EQ(splay_pq_pop_min(&pq), &expected.begin()->second->node);
+      expected.erase(expected.begin());
+    }
+    ASSERT_EQ(pq.count, expected.size());
+    ASSERT_EQ(splay_pq_peek_min(&pq), expected.empty() ? nullptr : &expected.begin()->second->node);
+  }
+  for(auto &timer : expected) {
+    ASSERT_EQ(splay_pq_pop_min(&pq), &timer.second->node);
+  }
+  ASSERT_EQ(pq.count, 0u);
+  ASSERT_EQ(splay_pq_peek_min(&pq), nullptr);
+
+  // by key alone, a second node with the same deadline is refused
+  splay_pq_init(&pq, compare<data_node, struct splay_node>);
+  timers[0].key = timers[1].key = 7;
+  ASSERT_TRUE(splay_pq_push(&pq, &timers[0].node));
+  ASSERT_FALSE(splay_pq_push(&pq, &timers[1].node));
+  ASSERT_EQ(pq.count, 1u);
+  ASSERT_EQ(splay_pq_pop_min(&pq), &timers[0].node);
+
+  // pushing a queued node again leaves the queue as it was, popped and cancelled ones go back in
+  splay_pq_init(&pq, compare_timer);
+  for(int i = 0; i < 5; i ++) {
+    timers[i].key = i;
+    ASSERT_TRUE(splay_pq_push(&pq, &timers[i].node));
+    ASSERT_FALSE(splay_pq_push(&pq, &timers[i].node));
+    ASSERT_FALSE(splay_pq_push(&pq, &timers[0].node));
+  }
+  ASSERT_EQ(pq.count, 5u);
+  splay_pq_cancel(&pq, &timers[2].node);
+  ASSERT_TRUE(splay_pq_push(&pq, &timers[2].node));
+  ASSERT_EQ(splay_pq_pop_min(&pq), &timers[0].node);
+  ASSERT_TRUE(splay_pq_push(&pq, &timers[0].node));
+  ASSERT_EQ(pq.count, 5u);
+  for(int i = 0; i < 5; i ++) {
+    ASSERT_EQ(splay_pq_pop_min(&pq), &timers[i].node);
+  }
+  ASSERT_EQ(splay_pq_pop_min(&pq), nullptr);
+}
+
+#endif
+
+TEST(SplayParallel, BuildUnsorted) {
+  const int count = 100000;
+  std::vector<data_node> data(count);
+  std::vector<splay_node *> nodes(count);
+
+  for(int threads : {1, 3, 8}) {
+    std::set<int> keys;
+    for(int i = 0; i < count; i ++) {
+      data[i].key = rand() % (count / 2);
+      keys.insert(data[i].key);
+      nodes[i] = &data[i].node;
+    }
+
+    splay_tree tree;
+    splay_tree_init(&tree);
+    size_t unique;
+    ASSERT_EQ(splay_build_parallel(&tree, nodes.data(), count, compare<data_node, struct splay_node>, threads, &unique), 0);
+    ASSERT_EQ(unique, keys.size());
+
+    // the first of the equal nodes in input order is the one linked
+    std::vector<bool> seen(count / 2);
+    for(int i = 0; i < count; i ++) {
+      int key = data[i].key;
+      if (seen[key]) continue;
+      seen[key] = true;
+      data_node query;
+      query.key = key;
+      ASSERT_EQ(splay_search(&tree, &query.node, compare<data_node, struct splay_node>), &data[i].node);
+    }
+    for(size_t i = unique; i < (size_t) count; i ++) {
+      data_node query;
+      query.key = _get_entry(nodes[i], data_node, node)->key;
+      ASSERT_NE(splay_search(&tree, &query.node, compare<data_node, struct splay_node>), nodes[i]);
+    }
+
+    auto it = keys.begin();
+    for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>), it ++) {
+      ASSERT_EQ(_get_entry(cur, data_node, node)->key, *it);
+    }
+    ASSERT_EQ(it, keys.end());
+  }
+}
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+static void collect_keys(splay_node *node, void *arg) {
+  ((std::vector<int> *) arg)->push_back(_get_entry(node, data_node, node)->key);
+}
+
+static std::vector<int> tree_keys(splay_tree *tree) {
+  std::vector<int> keys;
+  for(splay_node *cur = splay_first(tree); cur; cur = splay_next(tree, cur, compare<data_node, struct splay_node>)) {
+    keys.push_back(_get_entry(cur, data_node, node)->key);
+  }
+  return keys;
+}
+
+TEST(SplaySet, Algebra) {
+  auto func = compare<data_node, struct splay_node>;
+  // similar sizes take the linear merge, the others the lookups in the bigger tree
+  for(auto sizes : std::vector<std::pair<int, int>>{{3000, 2000}, {5, 3000}, {3000, 5}, {0, 100}}) {
+    std::vector<data_node> nodesA(sizes.first), nodesB(sizes.second);
+    std::set<int> keysA, keysB;
+    splay_tree a, b;
+
+    auto fill = [&]() {
+      keysA.clear();
+      keysB.clear();
+      splay_tree_init(&a);
+      splay_tree_init(&b);
+      for(auto &node : nodesA) {
+        node.key = rand() % 4000;
+        if (keysA.insert(node.key).second) splay_insert(&a, &node.node, func);
+      }
+      for(auto &node : nodesB) {
+        node.key = rand() % 4000;
+        if (keysB.insert(node.key).second) splay_insert(&b, &node.node, func);
+      }
+    };
+    std::vector<int> expected, result, dropped;
+
+    fill();
+    std::set_union(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    splay_set_visit(&a, &b, func, SPLAY_SET_UNION, collect_keys, &result);
+    ASSERT_EQ(result, expected);
+    expected.clear();
+    result.clear();
+    std::set_intersection(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    splay_set_visit(&a, &b, func, SPLAY_SET_INTERSECTION, collect_keys, &result);
+    ASSERT_EQ(result, expected);
+    expected.clear();
+    result.clear();
+    std::set_difference(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    splay_set_visit(&a, &b, func, SPLAY_SET_DIFFERENCE, collect_keys, &result);
+    ASSERT_EQ(result, expected);
+    ASSERT_EQ(tree_keys(&a), std::vector<int>(keysA.begin(), keysA.end()));
+    ASSERT_EQ(tree_keys(&b), std::vector<int>(keysB.begin(), keysB.end()));
+
+    // destructive: b keeps the nodes equal to one of a
+    expected.clear();
+    std::set_union(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    ASSERT_EQ(splay_set_union(&a, &b, func), expected.size() - keysA.size());
+    ASSERT_EQ(tree_keys(&a), expected);
+    expected.clear();
+    std::set_intersection(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    ASSERT_EQ(tree_keys(&b), expected);
+
+    fill();
+    expected.clear();
+    std::set_intersection(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    dropped.clear();
+    ASSERT_EQ(splay_set_intersect(&a, &b, func, collect_keys, &dropped), keysA.size() - expected.size());
+    ASSERT_EQ(tree_keys(&a), expected);
+    ASSERT_EQ(dropped.size(), keysA.size() - expected.size());
+
+    fill();
+    expected.clear();
+    std::set_difference(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+    ASSERT_EQ(splay_set_subtract(&a, &b, func, NULL, NULL), keysA.size() - expected.size());
+    ASSERT_EQ(tree_keys(&a), expected);
+    ASSERT_EQ(tree_keys(&b), std::vector<int>(keysB.begin(), keysB.end()));
+  }
+}
+
+#endif
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+TEST(SplayCpp, SetLikeStdSet) {
+  splay::set<int> set;
+  std::set<int> expected;
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    int key = rand() % (NO_ENTRIES / 2);
+    ASSERT_EQ(set.insert(key).second, expected.insert(key).second);
+  }
+  ASSERT_EQ(set.size(), expected.size());
+  ASSERT_TRUE(std::equal(set.begin(), set.end(), expected.begin()));
+  ASSERT_TRUE(std::equal(set.rbegin(), set.rend(), expected.rbegin()));
+
+  for(int key = -1; key <= NO_ENTRIES / 2; key ++) {
+    ASSERT_EQ(set.count(key), expected.count(key));
+    auto lower = set.lower_bound(key);
+    auto upper = set.upper_bound(key);
+    ASSERT_EQ(lower == set.end() ? -2 : *lower, expected.lower_bound(key) == expected.end() ? -2 : *expected.lower_bound(key));
+    ASSERT_EQ(upper == set.end() ? -2 : *upper, expected.upper_bound(key) == expected.end() ? -2 : *expected.upper_bound(key));
+  }
+
+  for(int i = 0; i < NO_ENTRIES; i ++) {
+    int key = rand() % (NO_ENTRIES / 2);
+    ASSERT_EQ(set.erase(key), expected.erase(key));
+  }
+  // erase by iterator returns the next one
+  for(auto it = set.begin(); it != set.end(); ) {
+    it = (*it % 3) ? std::next(it) : set.erase(it);
+  }
+  for(auto it = expected.begin(); it != expected.end(); ) {
+    it = (*it % 3) ? std::next(it) : expected.erase(it);
+  }
+
+  splay::set<int> copy(set), moved(std::move(copy));
+  ASSERT_TRUE(copy.empty());
+  std::vector<int> walked;
+  for(int key : moved) {
+    walked.push_back(key);
+  }
+  ASSERT_EQ(walked, std::vector<int>(expected.begin(), expected.end()));
+  ASSERT_EQ(*--moved.end(), *expected.rbegin());
+  moved.clear();
+  ASSERT_EQ(moved.begin(), moved.end());
+}
+
+TEST(SplayCpp, MapLikeStdMap) {
+  splay::map<std::string, int> map;
+  map["b"] = 2;
+  map["a"] = 1;
+  ASSERT_TRUE(map.insert({"c", 3}).second);
+  ASSERT_FALSE(map.emplace("a", 10).second);
+  map["a"] += 10;
+
+  std::vector<std::pair<std::string, int>> pairs(map.begin(), map.end());
+  ASSERT_EQ(pairs, (std::vector<std::pair<std::string, int>>{{"a", 11}, {"b", 2}, {"c", 3}}));
+  ASSERT_EQ(map.at("c"), 3);
+  ASSERT_THROW(map.at("d"), std::out_of_range);
+  ASSERT_EQ(map.find("b")->second, 2);
+  ASSERT_EQ(map.upper_bound("b")->first, "c");
+  ASSERT_EQ(map.erase("b"), 1u);
+  ASSERT_EQ(map.find("b"), map.end());
+  ASSERT_EQ(map.size(), 2u);
+
+  const splay::map<std::string, int> &view = map;
+  ASSERT_EQ(view.lower_bound("aa")->first, "c");
+}
+
+#endif
+
+struct cache_node {
+  int key;
+  splay_cache_entry entry;
+};
+
+static int compare_cache(splay_node *lhs, splay_node *rhs) {
+  return _get_entry(lhs, cache_node, entry.node)->key - _get_entry(rhs, cache_node, entry.node)->key;
+}
+
+static void collect_evicted(splay_cache_entry *entry, void *arg) {
+  ((std::vector<int> *) arg)->push_back(_get_entry(entry, cache_node, entry)->key);
+}
+
+TEST(SplayCache, Eviction) {
+  std::vector<cache_node> nodes(200);
+  std::vector<int> evicted;
+  splay_cache cache;
+  cache_node query;
+
+  // LRU by entries: a hit protects the entry from the next eviction
+  splay_cache_init(&cache, compare_cache, SPLAY_CACHE_LRU, 4, 0, collect_evicted, &evicted);
+  for(int i = 0; i < 4; i ++) {
+    nodes[i].key = i;
+    nodes[i].entry.charge = 1;
+    splay_cache_put(&cache, &nodes[i].entry);
+  }
+  query.key = 0;
+  ASSERT_EQ(splay_cache_get(&cache, &query.entry.node), &nodes[0].entry);
+  nodes[4].key = 4;
+  nodes[4].entry.charge = 1;
+  splay_cache_put(&cache, &nodes[4].entry);
+  ASSERT_EQ(evicted, std::vector<int>({1}));
+  query.key = 1;
+  ASSERT_EQ(splay_cache_get(&cache, &query.entry.node), nullptr);
+
+  // replacing an entry hands the old one out, erase does not
+  nodes[5].key = 2;
+  nodes[5].entry.charge = 1;
+  splay_cache_put(&cache, &nodes[5].entry);
+  ASSERT_EQ(evicted, std::vector<int>({1, 2}));
+  query.key = 2;
+  ASSERT_EQ(splay_cache_get(&cache, &query.entry.node), &nodes[5].entry);
+  ASSERT_EQ(splay_cache_erase(&cache, &query.entry.node), &nodes[5].entry);
+  ASSERT_EQ(cache.count, 3u);
+
+  // putting a cached entry again keeps it linked, recharges it and makes it the most recent
+  evicted.clear();
+  splay_cache_init(&cache, compare_cache, SPLAY_CACHE_LRU, 3, 10, collect_evicted, &evicted);
+  for(int i = 0; i < 3; i ++) {
+    nodes[i].key = i;
+    nodes[i].entry.charge = 2;
+    splay_cache_put(&cache, &nodes[i].entry);
+  }
+  nodes[0].entry.charge = 5;
+  splay_cache_put(&cache, &nodes[0].entry);
+  ASSERT_TRUE(evicted.empty());
+  ASSERT_EQ(cache.count, 3u);
+  ASSERT_EQ(cache.bytes, 9u);
+  ASSERT_EQ(cache.head, &nodes[0].entry);
+  query.key = 0;
+  ASSERT_EQ(splay_cache_get(&cache, &query.entry.node), &nodes[0].entry);
+  nodes[0].entry.charge = 7;
+  splay_cache_put(&cache, &nodes[0].entry);
+  ASSERT_EQ(evicted, std::vector<int>({1}));
+  ASSERT_EQ(cache.count, 2u);
+  ASSERT_EQ(cache.bytes, 9u);
+
+  // both policies stay within a byte budget
+  for(auto policy : {SPLAY_CACHE_LRU, SPLAY_CACHE_DEEPEST}) {
+    evicted.clear();
+    splay_cache_init(&cache, compare_cache, policy, 0, 1000, collect_evicted, &evicted);
+    for(int i = 0; i < 2000; i ++) {
+      int k = rand() % 200;
+      query.key = k;
+      if (splay_cache_get(&cache, &query.entry.node)) continue;
+      nodes[k].key = k;
+      nodes[k].entry.charge = 10 + k % 50;
+      splay_cache_put(&cache, &nodes[k].entry);
+      ASSERT_LE(cache.bytes, 1000u);
+
+      size_t count = 0, bytes = 0;
+      for(splay_node *cur = splay_first(&cache.tree); cur; cur = splay_next(&cache.tree, cur, compare_cache)) {
+        count ++;
+        bytes += _get_entry(cur, splay_cache_entry, node)->charge;
+      }
+      ASSERT_EQ(count, cache.count);
+      ASSERT_EQ(bytes, cache.bytes);
+    }
+    ASSERT_FALSE(evicted.empty());
+  }
+}
+
+#ifdef _SPLAY_AUGMENT
+
+struct sum_node {
+  int key;
+  int value;
+  int64_t sum;    // of the values in the subtree
+  int max;
+  splay_node node;
+};
+
+static void sum_update(splay_node *node) {
+  sum_node *cur = _get_entry(node, sum_node, node);
+  cur->sum = cur->max = cur->value;
+  for(splay_node *child : {splay_left(node), splay_right(node)}) {
+    if (!child) continue;
+    cur->sum += _get_entry(child, sum_node, node)->sum;
+    cur->max = std::max(cur->max, _get_entry(child, sum_node, node)->max);
+  }
+}
+
+static void sum_visit(splay_node *node, bool subtree, void *arg) {
+  sum_node *cur = _get_entry(node, sum_node, node);
+  std::pair<int64_t, int> *acc = (std::pair<int64_t, int> *) arg;
+  acc->first += subtree ? cur->sum : cur->value;
+  acc->second = std::max(acc->second, subtree ? cur->max : cur->value);
+}
+
+TEST(SplayTree, RangeAggregate) {
+  const int n = 2000;
+  std::vector<sum_node> nodes(n);
+  std::set<int> keys;
+  splay_tree tree;
+  splay_tree_init_augmented(&tree, sum_update);
+
+  for(int i = 0; i < 20000; i ++) {
+    int k = rand() % n;
+    nodes[k].key = k;
+    if (rand() % 3) {
+      if (keys.insert(k).second) {
+        nodes[k].value = rand() % 1000;
+        splay_insert(&tree, &nodes[k].node, compare<sum_node, struct splay_node>);
+      }
+    } else if (keys.erase(k)) {
+      splay_delete(&tree, &nodes[k].node, compare<sum_node, struct splay_node>);
+    }
+
+    sum_node lo, hi;
+    lo.key = rand() % n - 10;
+    hi.key = lo.key + rand() % (i % 2 ? 40 : n);
+    std::pair<int64_t, int> expected(0, -1), acc(0, -1);
+    for(auto it = keys.lower_bound(lo.key); it != keys.end() && *it <= hi.key; it ++) {
+      expected.first += nodes[*it].value;
+      expected.second = std::max(expected.second, nodes[*it].value);
+    }
+    splay_range_aggregate(&tree, &lo.node, &hi.node, compare<sum_node, struct splay_node>, sum_visit, &acc);
+    ASSERT_EQ(acc, expected);
+  }
+
+  // the whole tree is one part after splay_first, and iteration still works
+  std::pair<int64_t, int> acc(0, -1);
+  for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<sum_node, struct splay_node>)) {
+    sum_visit(cur, false, &acc);
+  }
+  if (tree.root) {
+    ASSERT_EQ(_get_entry(tree.root, sum_node, node)->sum, acc.first);
+  }
+}
+
+static bool collect_interval(splay_interval *interval, void *arg) {
+  ((std::vector<splay_interval *> *) arg)->push_back(interval);
+  return true;
+}
+
+TEST(SplayInterval, Overlap) {
+  const int n = 3000;
+  std::vector<splay_interval> intervals(n);
+  std::vector<bool> linked(n, false);
+  splay_tree tree;
+  splay_interval_init(&tree);
+
+  for(int i = 0; i < n; i ++) {
+    intervals[i].start = rand() % 100000;
+    intervals[i].end = intervals[i].start + 1 + (i % 10 ? rand() % 100 : rand() % 20000);
+    splay_interval_insert(&tree, &intervals[i]);
+    linked[i] = true;
+  }
+
+  for(int round = 0; round < 2000; round ++) {
+    if (round % 4 == 0) {
+      int i = rand() % n;
+      if (linked[i]) splay_interval_delete(&tree, &intervals[i]);
+      else splay_interval_insert(&tree, &intervals[i]);
+      linked[i] = !linked[i];
+    }
+
+    // a point, then a range
+    uint64_t lo = rand() % 110000, hi = lo + (round % 2 ? 1 : rand() % 1000 + 1);
+    std::vector<splay_interval *> expected, found;
+    for(int i = 0; i < n; i ++) {
+      if (linked[i] && intervals[i].start < hi && intervals[i].end > lo) expected.push_back(&intervals[i]);
+    }
+    ASSERT_EQ(splay_interval_overlap(&tree, lo, hi, collect_interval, &found), expected.size());
+    for(size_t i = 1; i < found.size(); i ++) {
+      ASSERT_LE(found[i - 1]->start, found[i]->start);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+}
+
+TEST(SplayInterval, OverlapOutOfMemory) {
+  const int n = 4096;
+  std::vector<splay_interval> intervals(n);
+  std::vector<splay_interval *> found;
+  splay_tree tree;
+  splay_interval_init(&tree);
+
+  // every interval overlaps the query, the walk goes down a long left path to the first one
+  for(int i = 0; i < n; i ++) {
+    intervals[i].start = i;
+    intervals[i].end = n;
+    splay_interval_insert(&tree, &intervals[i]);
+  }
+
+  fail_malloc = true;
+  size_t count = splay_interval_overlap(&tree, 0, n, collect_interval, &found);
+  fail_malloc = false;
+  ASSERT_EQ(count, SPLAY_INTERVAL_ERROR);
+
+  found.clear();
+  ASSERT_EQ(splay_interval_overlap(&tree, 0, n, collect_interval, &found), (size_t) n);
+}
+
+#endif
+
+TEST(SplaySimd, LowerBound) {
+  uint32_t keys32[67];
+  uint64_t keys64[67];
+  for(int i = 0; i < 67; i ++) {
+    // values across the sign bit to catch signed compares
+    keys32[i] = 0x7ffffff0u + i * 3;
+    keys64[i] = 0x7ffffffffffffff0ull + i * 3;
+  }
+
+  for(int level = SPLAY_SIMD_SCALAR; level <= splay_simd_detect(); level ++) {
+    ASSERT_EQ(splay_simd_select((splay_simd_level) level), level);
+    for(uint32_t count = 0; count <= 67; count ++) {
+      for(uint32_t i = 0; i <= 3 * 67 + 1; i ++) {
+        uint32_t key32 = 0x7fffffefu + i;
+        uint64_t key64 = 0x7fffffffffffffefull + i;
+        ASSERT_EQ(splay_lower_bound_u32(keys32, count, key32),
+                  std::lower_bound(keys32, keys32 + count, key32) - keys32);
+        ASSERT_EQ(splay_lower_bound_u64(keys64, count, key64),
+                  std::lower_bound(keys64, keys64 + count, key64) - keys64);
+      }
+    }
+  }
+  splay_simd_select(SPLAY_SIMD_AVX2);
+}
+
+TEST(SplayTree, IterateAfterRandomOps) {
+  const int n = 1000;
+  std::vector<data_node> data(n);
+  std::set<int> expected;
+  splay_tree tree;
+  splay_tree_init(&tree);
+  for(int i = 0; i < n; i ++) data[i].key = i;
+
+  for(int r = 0; r < 20 * n; r ++) {
+    int key = rand() % n;
+    if (rand() % 3) {
+      if (expected.count(key)) continue;
+      splay_insert(&tree, &data[key].node, compare<data_node, struct splay_node>);
+      expected.insert(key);
+    } else {
+      splay_delete(&tree, &data[key].node, compare<data_node, struct splay_node>);
+      expected.erase(key);
+    }
+  }
+
+  std::vector<int> keys;
+  for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>)) {
+    keys.push_back(_get_entry(cur, data_node, node)->key);
+  }
+  ASSERT_EQ(keys, std::vector<int>(expected.begin(), expected.end()));
+
+  keys.clear();
+  for(splay_node *cur = splay_last(&tree); cur; cur = splay_prev(&tree, cur, compare<data_node, struct splay_node>)) {
+    keys.push_back(_get_entry(cur, data_node, node)->key);
+  }
+  ASSERT_EQ(keys, std::vector<int>(expected.rbegin(), expected.rend()));
+}
+
+#ifdef _SPLAY_XOR_SIBLING
+TEST(SplayTree, XorCursor) {
+  const int n = 500;
+  std::vector<data_node> data(n);
+  std::set<int> expected;
+  splay_tree tree;
+  splay_cursor cursor;
+  splay_tree_init(&tree);
+  for(int i = 0; i < n; i ++) data[i].key = 2 * i;
+
+  for(int r = 0; r < 20 * n; r ++) {
+    int idx = rand() % n;
+    if (rand() % 3) {
+      if (expected.count(2 * idx)) continue;
+      splay_insert(&tree, &data[idx].node, compare<data_node, struct splay_node>);
+      expected.insert(2 * idx);
+    } else {
+      splay_delete(&tree, &data[idx].node, compare<data_node, struct splay_node>);
+      expected.erase(2 * idx);
+    }
+  }
+
+  std::vector<int> keys;
+  for(splay_cursor_first(&tree, &cursor); cursor.node; splay_cursor_next(&cursor)) {
+    keys.push_back(_get_entry(cursor.node, data_node, node)->key);
+  }
+  ASSERT_EQ(keys, std::vector<int>(expected.begin(), expected.end()));
+
+  keys.clear();
+  for(splay_cursor_last(&tree, &cursor); cursor.node; splay_cursor_prev(&cursor)) {
+    keys.push_back(_get_entry(cursor.node, data_node, node)->key);
+  }
+  ASSERT_EQ(keys, std::vector<int>(expected.rbegin(), expected.rend()));
+
+  // start in the middle, one step each way
+  data_node query;
+  for(int key = -1; key <= 2 * n; key ++) {
+    query.key = key;
+    auto it = expected.lower_bound(key);
+    splay_cursor_greater(&tree, &query.node, compare<data_node, struct splay_node>, &cursor);
+    ASSERT_EQ(cursor.node ? _get_entry(cursor.node, data_node, node)->key : -1, it == expected.end() ? -1 : *it);
+    splay_cursor_prev(&cursor);
+    ASSERT_EQ(cursor.node ? _get_entry(cursor.node, data_node, node)->key : -1,
+              it == expected.begin() ? -1 : *std::prev(it));
+
+    auto up = expected.upper_bound(key);
+    splay_cursor_lower(&tree, &query.node, compare<data_node, struct splay_node>, &cursor);
+    ASSERT_EQ(cursor.node ? _get_entry(cursor.node, data_node, node)->key : -1, up == expected.begin() ? -1 : *std::prev(up));
+    if (cursor.node) {
+      splay_cursor_next(&cursor);
+      ASSERT_EQ(cursor.node ? _get_entry(cursor.node, data_node, node)->key : -1, up == expected.end() ? -1 : *up);
+    }
+  }
+}
+#endif
+
+TEST(SplayTree, SmallSizeThreshold) {
+  // key ranges around the small array size, so the tree keeps promoting and demoting
+  const int rounds = 4000;
+  data_node data[32];
+  splay_tree tree;
+  std::set<int> expected;
+  splay_tree_init(&tree);
+  for(int i = 0; i < 32; i ++) data[i].key = i;
+
+  for(int r = 0; r < rounds; r ++) {
+    int range = (r / 500) % 2 ? 32 : 12;
+    int key = rand() % range;
+    if (rand() % 2) {
+      // insert resets the node links, so only hand in nodes that are not linked yet
+      if (expected.count(key)) continue;
+      splay_insert(&tree, &data[key].node, compare<data_node, struct splay_node>);
+      expected.insert(key);
+    } else {
+      splay_delete(&tree, &data[key].node, compare<data_node, struct splay_node>);
+      expected.erase(key);
+    }
+
+#ifdef _SPLAY_SMALL_TREE
+    if (expected.size() < _SPLAY_SMALL_SIZE / 2) {
+      ASSERT_EQ(tree.root, nullptr);
+    }
+    if (expected.size() > _SPLAY_SMALL_SIZE) {
+      ASSERT_NE(tree.root, nullptr);
+    }
+#endif
+
+    data_node query;
+    query.key = rand() % range;
+    splay_node *cur = splay_search(&tree, &query.node, compare<data_node, struct splay_node>);
+    ASSERT_EQ(cur != nullptr, expected.count(query.key) == 1);
+    cur = splay_search_greater(&tree, &query.node, compare<data_node, struct splay_node>);
+    auto it = expected.lower_bound(query.key);
+    ASSERT_EQ(cur ? _get_entry(cur, data_node, node)->key : -1, it == expected.end() ? -1 : *it);
+
+    std::vector<int> keys;
+    for(cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>)) {
+      keys.push_back(_get_entry(cur, data_node, node)->key);
+    }
+    ASSERT_EQ(keys, std::vector<int>(expected.begin(), expected.end()));
+    cur = splay_last(&tree);
+    ASSERT_EQ(cur ? _get_entry(cur, data_node, node)->key : -1, expected.empty() ? -1 : *expected.rbegin());
+  }
+}
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+TEST(SplayTree, Multiset) {
+  const int n = 2000, range = 50;
+  std::vector<data_node> data(n);
+  std::multiset<int> expected;
+  splay_tree tree;
+  splay_tree_init(&tree);
+
+  for(int i = 0; i < n; i ++) {
+    data[i].key = rand() % range;
+    splay_insert_multi(&tree, &data[i].node, compare<data_node, struct splay_node>);
+    expected.insert(data[i].key);
+  }
+
+  // duplicates come out in insertion order
+  std::vector<data_node*> order;
+  for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>)) {
+    order.push_back(_get_entry(cur, data_node, node));
+  }
+  ASSERT_EQ(order.size(), (size_t) n);
+  for(int i = 1; i < n; i ++) {
+    ASSERT_LE(order[i - 1]->key, order[i]->key);
+    if (order[i - 1]->key == order[i]->key) {
+      ASSERT_LT(order[i - 1], order[i]);
+    }
+  }
+
+  data_node query;
+  for(int key = -1; key <= range; key ++) {
+    query.key = key;
+    splay_node *end, *first = splay_equal_range(&tree, &query.node, compare<data_node, struct splay_node>, &end);
+    ASSERT_EQ(splay_count_equal(&tree, &query.node, compare<data_node, struct splay_node>), expected.count(key));
+    ASSERT_EQ(first == nullptr, expected.count(key) == 0);
+    auto upper = expected.upper_bound(key);
+    ASSERT_EQ(end ? _get_entry(end, data_node, node)->key : -1, upper == expected.end() ? -1 : *upper);
+  }
+
+  for(int key = 0; key < range; key ++) {
+    query.key = key;
+    if (key % 2) {
+      splay_delete(&tree, &query.node, compare<data_node, struct splay_node>);
+      expected.erase(expected.find(key));
+    } else {
+      ASSERT_EQ(splay_delete_all(&tree, &query.node, compare<data_node, struct splay_node>), expected.erase(key));
+    }
+    ASSERT_EQ(splay_count_equal(&tree, &query.node, compare<data_node, struct splay_node>), expected.count(key));
+  }
+
+  size_t count = 0;
+  for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>)) {
+    count ++;
+  }
+  ASSERT_EQ(count, expected.size());
+
+  // a linked duplicate is removed itself, a query node removes the first of its equal ones
+  for(int size : {5, 300}) {
+    std::vector<data_node> dups(size);
+    std::vector<data_node*> left;
+    splay_tree_init(&tree);
+    for(int i = 0; i < size; i ++) {
+      dups[i].key = i % 3;
+      splay_insert_multi(&tree, &dups[i].node, compare<data_node, struct splay_node>);
+    }
+    for(int key = 0; key < 3; key ++) {
+      for(int i = key; i < size; i += 3) left.push_back(&dups[i]);
+    }
+
+    for(int step = 0; step < size; step ++) {
+      auto victim = left.begin() + rand() % left.size();
+      if (step % 4 == 0) {
+        query.key = (*victim)->key;
+        splay_delete_multi(&tree, &query.node, compare<data_node, struct splay_node>);
+        while (victim != left.begin() && (*(victim - 1))->key == query.key) victim --;
+      } else {
+        splay_delete_multi(&tree, &(*victim)->node, compare<data_node, struct splay_node>);
+      }
+      left.erase(victim);
+
+      order.clear();
+      for(splay_node *cur = splay_first(&tree); cur; cur = splay_next(&tree, cur, compare<data_node, struct splay_node>)) {
+        order.push_back(_get_entry(cur, data_node, node));
+      }
+      ASSERT_EQ(order, left);
+    }
+  }
+}
+#endif
+
 TEST(RedBlackTree, CursorOperation) {
   kv_node_rb data[NO_ENTRIES+1];
   rb_root tree;
@@ -0,0 +1,221 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <stdlib.h>
+
+#include "splay_arena.h"
+
+#define SPLAY_ARENA_MIN_CAPACITY 16
+
+INLINE struct splay_arena_link *_arena_ptr(struct splay_arena *arena, uint32_t id) {
+  return id ? arena->links + id : NULL;
+}
+
+INLINE uint32_t _arena_id(struct splay_arena *arena, struct splay_arena_link *p) {
+  return p ? (uint32_t) (p - arena->links) : 0;
+}
+
+INLINE int _arena_cmp(struct splay_arena_link *node, struct splay_arena_link *query) {
+  if (node->key == query->key) return 0;
+  return (node->key > query->key) ? 1 : -1;
+}
+
+// the id instance of the template: links[] holds the tree links, siblings[] the in-order
+// chain, both indexed by id; keys are compared inline and the names are its own
+#undef _SPLAY_AUGMENT
+#undef _SPLAY_THREADED
+#undef _SPLAY_XOR_SIBLING
+#undef _SPLAY_INSERT_RANDOM
+#ifndef _SPLAY_SIBLING_POINTER
+#define _SPLAY_SIBLING_POINTER
+#endif
+#define _SPLAY_NODE             struct splay_arena_link
+#define _SPLAY_TREE             struct splay_arena
+#define _SPLAY_FUNC             void
+#define _SPLAY_CMP(node, query) _arena_cmp(node, query)
+
+#define _SPLAY_LINK_ACCESS
+#define _sibling(p)           (tree->siblings[(p) - tree->links])
+#define _left(p)              _arena_ptr(tree, (p)->left)
+#define _right(p)             _arena_ptr(tree, (p)->right)
+#define _prev(p)              _arena_ptr(tree, _sibling(p).prev)
+#define _next(p)              _arena_ptr(tree, _sibling(p).next)
+#define _root(t)              _arena_ptr(t, (t)->root)
+#define _set_left(p, v)       ((p)->left = _arena_id(tree, v))
+#define _set_right(p, v)      ((p)->right = _arena_id(tree, v))
+#define _set_prev(p, v)       (_sibling(p).prev = _arena_id(tree, v))
+#define _set_next(p, v)       (_sibling(p).next = _arena_id(tree, v))
+#define _set_root(t, v)       ((t)->root = _arena_id(t, v))
+
+#define _right_rotate         _right_rotate_arena
+#define _left_rotate          _left_rotate_arena
+#define _leftmost             _leftmost_arena
+#define _rightmost            _rightmost_arena
+#define _pred                 _pred_arena
+#define _succ                 _succ_arena
+#define _init_splay_node      _init_splay_node_arena
+#define _bias_cmp             _bias_cmp_arena
+#define _splay_bias           _splay_bias_arena
+#define _splay                _splay_arena
+#define _link_root            _link_root_arena
+#define _tree_insert          _tree_insert_arena
+#define _unlink_root          _unlink_root_arena
+#define _tree_delete          _tree_delete_arena
+#define _tree_prev            _tree_prev_arena
+#define _tree_next            _tree_next_arena
+#define _tree_search          _tree_search_arena
+#define _tree_search_lower    _tree_search_lower_arena
+#define _tree_search_greater  _tree_search_greater_arena
+#define _tree_first           _tree_first_arena
+#define _tree_last            _tree_last_arena
+
+#include "splaytree.inc"
+
+static int _arena_grow(struct splay_arena *arena) {
+  if (arena->capacity > UINT32_MAX / 2) return -1;
+  uint32_t capacity = arena->capacity * 2;
+
+  struct splay_arena_link *links = (struct splay_arena_link *)
+    realloc(arena->links, (size_t) capacity * sizeof(struct splay_arena_link));
+  if (!links) return -1;
+  arena->links = links;
+
+  struct splay_arena_sibling *siblings = (struct splay_arena_sibling *)
+    realloc(arena->siblings, (size_t) capacity * sizeof(struct splay_arena_sibling));
+  if (!siblings) return -1;
+  arena->siblings = siblings;
+
+  arena->capacity = capacity;
+  return 0;
+}
+
+static uint32_t _arena_alloc(struct splay_arena *arena) {
+  uint32_t id = arena->free_list;
+  if (id) {
+    arena->free_list = arena->links[id].right;
+    return id;
+  }
+  if (arena->used == arena->capacity && _arena_grow(arena) < 0) return 0;
+  return arena->used ++;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+int splay_arena_init(struct splay_arena *arena, uint32_t capacity) {
+  if (capacity < SPLAY_ARENA_MIN_CAPACITY) capacity = SPLAY_ARENA_MIN_CAPACITY;
+  arena->links = (struct splay_arena_link *) calloc(capacity, sizeof(struct splay_arena_link));
+  arena->siblings = (struct splay_arena_sibling *) calloc(capacity, sizeof(struct splay_arena_sibling));
+  arena->root = arena->count = arena->free_list = 0;
+  arena->used = 1;
+  arena->capacity = capacity;
+  if (!arena->links || !arena->siblings) {
+    splay_arena_free(arena);
+    return -1;
+  }
+  return 0;
+}
+
+void splay_arena_free(struct splay_arena *arena) {
+  free(arena->links);
+  free(arena->siblings);
+  arena->links = NULL;
+  arena->siblings = NULL;
+  arena->root = arena->count = arena->capacity = arena->used = arena->free_list = 0;
+}
+
+uint32_t splay_arena_insert(struct splay_arena *arena, uint64_t key) {
+  struct splay_arena_link query, *node;
+  int cmp = 0;
+  query.key = key;
+  _set_root(arena, _splay(_root(arena), &query, NULL, &cmp, arena));
+  if (arena->root && cmp == 0) return arena->root;
+
+  uint32_t id = _arena_alloc(arena);
+  if (!id) return 0;
+  // the arrays may have moved, so the node is only looked up now
+  node = arena->links + id;
+  node->key = key;
+  _init_splay_node(node, arena);
+  if (!arena->root) {
+    arena->root = id;
+  } else {
+    _link_root(arena, node, cmp);
+  }
+  arena->count ++;
+  return id;
+}
+
+bool splay_arena_delete(struct splay_arena *arena, uint64_t key) {
+  struct splay_arena_link query;
+  int cmp = 0;
+  query.key = key;
+  _set_root(arena, _splay(_root(arena), &query, NULL, &cmp, arena));
+  uint32_t id = arena->root;
+  if (!id || cmp != 0) return false;
+
+  _unlink_root(arena);
+  arena->links[id].right = arena->free_list;
+  arena->free_list = id;
+  arena->count --;
+  return true;
+}
+
+uint32_t splay_arena_search(struct splay_arena *arena, uint64_t key) {
+  struct splay_arena_link query;
+  query.key = key;
+  return _arena_id(arena, _tree_search(arena, &query, NULL));
+}
+
+uint32_t splay_arena_search_lower(struct splay_arena *arena, uint64_t key) {
+  struct splay_arena_link query;
+  query.key = key;
+  return _arena_id(arena, _tree_search_lower(arena, &query, NULL));
+}
+
+uint32_t splay_arena_search_greater(struct splay_arena *arena, uint64_t key) {
+  struct splay_arena_link query;
+  query.key = key;
+  return _arena_id(arena, _tree_search_greater(arena, &query, NULL));
+}
+
+uint32_t splay_arena_first(struct splay_arena *arena) {
+  return _arena_id(arena, _tree_first(arena));
+}
+
+uint32_t splay_arena_last(struct splay_arena *arena) {
+  return _arena_id(arena, _tree_last(arena));
+}
@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_ARENA
+#define _DUYNGUYEN_SPLAY_ARENA
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Splay tree of uint64_t keys with hot and cold links in separate arrays
+ *
+ * Nodes are 32-bit ids into arrays owned by the arena, id 0 is the null node. The tree links
+ * and the key, which are all a splay touches, are packed in 16 bytes per node in links[],
+ * while the in-order chain lives in siblings[] and is only touched by insert, delete and
+ * iteration. A deep search so fits four nodes per cache line instead of one node with
+ * embedded prev / next pointers, and splay_arena_next() is still O(1).
+ *
+ * The arrays grow by doubling, deleted ids are recycled. Ids stay valid across growth,
+ * pointers into the arrays do not.
+ */
+struct splay_arena_link {
+  uint32_t left, right;
+  uint64_t key;
+};
+
+struct splay_arena_sibling {
+  uint32_t prev, next;
+};
+
+struct splay_arena {
+  struct splay_arena_link *links;
+  struct splay_arena_sibling *siblings;
+  uint32_t root;
+  uint32_t count;
+  uint32_t capacity;    // ids below capacity are allocated, id 0 included
+  uint32_t used;        // ids below used have been handed out at least once
+  uint32_t free_list;   // recycled ids, chained through links[].right
+};
+
+int splay_arena_init(struct splay_arena *arena, uint32_t capacity);
+void splay_arena_free(struct splay_arena *arena);
+
+// id of the node holding key (inserted if needed), 0 when out of memory
+uint32_t splay_arena_insert(struct splay_arena *arena, uint64_t key);
+bool splay_arena_delete(struct splay_arena *arena, uint64_t key);
+
+// node ids, 0 when there is no such node
+uint32_t splay_arena_search(struct splay_arena *arena, uint64_t key);
+uint32_t splay_arena_search_lower(struct splay_arena *arena, uint64_t key);
+uint32_t splay_arena_search_greater(struct splay_arena *arena, uint64_t key);
+uint32_t splay_arena_first(struct splay_arena *arena);
+uint32_t splay_arena_last(struct splay_arena *arena);
+
+static inline uint64_t splay_arena_key(struct splay_arena *arena, uint32_t id) {
+  return arena->links[id].key;
+}
+
+static inline uint32_t splay_arena_prev(struct splay_arena *arena, uint32_t id) {
+  return arena->siblings[id].prev;
+}
+
+static inline uint32_t splay_arena_next(struct splay_arena *arena, uint32_t id) {
+  return arena->siblings[id].next;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "splay_block.h"
+#include "splay_simd.h"
+
+#define _BLOCK_MERGE_THRESHOLD (SPLAY_BLOCK_CAPACITY / 4)
+
+// blocks are ordered by their smallest key
+static int _block_cmp(struct splay_node *a, struct splay_node *b) {
+  uint64_t lhs = _get_entry(a, struct splay_block, node)->keys[0];
+  uint64_t rhs = _get_entry(b, struct splay_block, node)->keys[0];
+  return (lhs > rhs) - (lhs < rhs);
+}
+
+// index of the first key >= key, count if there is none
+INLINE uint32_t _block_lower_bound(const uint64_t *keys, uint32_t count, uint64_t key) {
+  return splay_lower_bound_u64(keys, count, key);
+}
+
+// the block whose range covers key: the last block starting at or before key
+INLINE struct splay_block *_block_locate(struct splay_block_tree *tree, uint64_t key) {
+  struct splay_block query;
+  query.keys[0] = key;
+  struct splay_node *cur = splay_search_lower(&tree->tree, &query.node, _block_cmp);
+  return cur ? _get_entry(cur, struct splay_block, node) : NULL;
+}
+
+INLINE struct splay_block *_block_new(void) {
+  struct splay_block *block = (struct splay_block *) malloc(sizeof(struct splay_block));
+  if (block) block->count = 0;
+  return block;
+}
+
+void splay_block_tree_init(struct splay_block_tree *tree) {
+  splay_tree_init(&tree->tree);
+  tree->count = 0;
+}
+
+void splay_block_tree_free(struct splay_block_tree *tree) {
+  // unroll left children into the right spine and free from the top, no recursion needed
+  struct splay_node *root = tree->tree.root, *next;
+#ifdef _SPLAY_SMALL_TREE
+  size_t idx;
+  for(idx = 0; !root && idx < tree->tree.count; idx ++) {
+    free(_get_entry(tree->tree.small[idx], struct splay_block, node));
+  }
+#endif
+  while (root) {
+    if (splay_left(root)) {
+      next = root->left;
+      root->left = next->right;
+      next->right = root;
+    } else {
+      next = splay_right(root);
+      free(_get_entry(root, struct splay_block, node));
+    }
+    root = next;
+  }
+  splay_block_tree_init(tree);
+}
+
+int splay_block_insert(struct splay_block_tree *tree, uint64_t key) {
+  struct splay_block *block = _block_locate(tree, key);
+  if (!block) {
+    // smaller than every key, it becomes the new minimum of the first block
+    struct splay_node *first = splay_first(&tree->tree);
+    if (!first) {
+      if (!(block = _block_new())) return -1;
+      block->keys[block->count ++] = key;
+      splay_insert(&tree->tree, &block->node, _block_cmp);
+      tree->count ++;
+      return 1;
+    }
+    block = _get_entry(first, struct splay_block, node);
+  }
+
+  uint32_t pos = _block_lower_bound(block->keys, block->count, key);
+  if (pos < block->count && block->keys[pos] == key) return 0;
+
+  if (block->count == SPLAY_BLOCK_CAPACITY) {
+    struct splay_block *upper = _block_new();
+    if (!upper) return -1;
+    upper->count = SPLAY_BLOCK_CAPACITY / 2;
+    block->count = SPLAY_BLOCK_CAPACITY - upper->count;
+    memcpy(upper->keys, block->keys + block->count, upper->count * sizeof(uint64_t));
+    splay_insert(&tree->tree, &upper->node, _block_cmp);
+    if (pos > block->count) {
+      pos -= block->count;
+      block = upper;
+    }
+  }
+
+  memmove(block->keys + pos + 1, block->keys + pos, (block->count - pos) * sizeof(uint64_t));
+  block->keys[pos] = key;
+  block->count ++;
+  tree->count ++;
+  return 1;
+}
+
+int splay_block_delete(struct splay_block_tree *tree, uint64_t key) {
+  struct splay_block *block = _block_locate(tree, key);
+  if (!block) return 0;
+
+  uint32_t pos = _block_lower_bound(block->keys, block->count, key);
+  if (pos == block->count || block->keys[pos] != key) return 0;
+
+  if (block->count == 1) {
+    splay_delete(&tree->tree, &block->node, _block_cmp);
+    free(block);
+    tree->count --;
+    return 1;
+  }
+
+  block->count --;
+  memmove(block->keys + pos, block->keys + pos + 1, (block->count - pos) * sizeof(uint64_t));
+  tree->count --;
+
+  if (block->count < _BLOCK_MERGE_THRESHOLD) {
+    struct splay_node *cur = splay_next(&tree->tree, &block->node, _block_cmp);
+    struct splay_block *next = cur ? _get_entry(cur, struct splay_block, node) : NULL;
+    if (next && block->count + next->count <= SPLAY_BLOCK_CAPACITY / 2) {
+      splay_delete(&tree->tree, &next->node, _block_cmp);
+      memcpy(block->keys + block->count, next->keys, next->count * sizeof(uint64_t));
+      block->count += next->count;
+      free(next);
+    }
+  }
+  return 1;
+}
+
+bool splay_block_search(struct splay_block_tree *tree, uint64_t key) {
+  struct splay_block *block = _block_locate(tree, key);
+  if (!block) return false;
+
+  uint32_t pos = _block_lower_bound(block->keys, block->count, key);
+  return pos < block->count && block->keys[pos] == key;
+}
+
+bool splay_block_search_lower(struct splay_block_tree *tree, uint64_t key, uint64_t *result) {
+  struct splay_block *block = _block_locate(tree, key);
+  if (!block) return false;
+
+  // keys[0] <= key, so there is always an answer inside the block
+  uint32_t pos = _block_lower_bound(block->keys, block->count, key);
+  if (pos == block->count || block->keys[pos] != key) pos --;
+  *result = block->keys[pos];
+  return true;
+}
+
+bool splay_block_search_greater(struct splay_block_tree *tree, uint64_t key, uint64_t *result) {
+  struct splay_block *block = _block_locate(tree, key);
+  if (!block) {
+    struct splay_node *first = splay_first(&tree->tree);
+    if (!first) return false;
+    *result = _get_entry(first, struct splay_block, node)->keys[0];
+    return true;
+  }
+
+  uint32_t pos = _block_lower_bound(block->keys, block->count, key);
+  if (pos == block->count) {
+    struct splay_node *next = splay_next(&tree->tree, &block->node, _block_cmp);
+    if (!next) return false;
+    *result = _get_entry(next, struct splay_block, node)->keys[0];
+    return true;
+  }
+  *result = block->keys[pos];
+  return true;
+}
@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_BLOCK
+#define _DUYNGUYEN_SPLAY_BLOCK
+
+#include "splaytree.h"
+
+#ifndef SPLAY_BLOCK_CAPACITY
+#define SPLAY_BLOCK_CAPACITY 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Ordered set of uint64_t keys kept as a splay tree of sorted key blocks
+ *
+ * Every node owns up to SPLAY_BLOCK_CAPACITY sorted keys and the tree is ordered by the
+ * smallest key of each block, so the self-adjusting part works at block granularity and
+ * the last step of a search is a SIMD scan over contiguous keys (see splay_simd.h). A full
+ * block is split in halves, a block that falls under a quarter full is merged with its
+ * successor.
+ *
+ * Unlike struct splay_tree, the container allocates its blocks with malloc().
+ */
+struct splay_block {
+  struct splay_node node;
+  uint32_t count;
+  uint64_t keys[SPLAY_BLOCK_CAPACITY];
+};
+
+struct splay_block_tree {
+  struct splay_tree tree;
+  size_t count;
+};
+
+void splay_block_tree_init(struct splay_block_tree *tree);
+void splay_block_tree_free(struct splay_block_tree *tree);
+
+int splay_block_insert(struct splay_block_tree *tree, uint64_t key);
+int splay_block_delete(struct splay_block_tree *tree, uint64_t key);
+
+bool splay_block_search(struct splay_block_tree *tree, uint64_t key);
+bool splay_block_search_lower(struct splay_block_tree *tree, uint64_t key, uint64_t *result);
+bool splay_block_search_greater(struct splay_block_tree *tree, uint64_t key, uint64_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include "splay_cache.h"
+
+#define _entry(p)  _get_entry(p, struct splay_cache_entry, node)
+
+INLINE void _lru_unlink(struct splay_cache *cache, struct splay_cache_entry *entry) {
+  if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+  else cache->head = entry->lru_next;
+  if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+  else cache->tail = entry->lru_prev;
+}
+
+INLINE void _lru_push(struct splay_cache *cache, struct splay_cache_entry *entry) {
+  entry->lru_prev = NULL;
+  entry->lru_next = cache->head;
+  if (cache->head) cache->head->lru_prev = entry;
+  else cache->tail = entry;
+  cache->head = entry;
+}
+
+// xorshift64, only steers the walk of SPLAY_CACHE_DEEPEST
+INLINE uint64_t _next_random(struct splay_cache *cache) {
+  uint64_t x = cache->random;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return cache->random = x;
+}
+
+static struct splay_cache_entry *_deepest(struct splay_cache *cache) {
+  struct splay_node *cur = cache->tree.root, *left, *right;
+#ifdef _SPLAY_SMALL_TREE
+  if (!cur) return cache->tree.count ? _entry(cache->tree.small[_next_random(cache) % cache->tree.count]) : NULL;
+#endif
+  if (!cur) return NULL;
+
+  uint64_t bits = _next_random(cache);
+  int used = 0;
+  for (;;) {
+    left = splay_left(cur);
+    right = splay_right(cur);
+    if (!left && !right) return _entry(cur);
+    if (used == 64) {
+      bits = _next_random(cache);
+      used = 0;
+    }
+    cur = (!right || (left && ((bits >> used ++) & 1))) ? left : right;
+  }
+}
+
+static void _remove(struct splay_cache *cache, struct splay_cache_entry *entry) {
+  splay_delete(&cache->tree, &entry->node, cache->func);
+  if (cache->policy == SPLAY_CACHE_LRU) _lru_unlink(cache, entry);
+  cache->count --;
+  cache->bytes -= entry->charged;
+}
+
+INLINE bool _over_limit(struct splay_cache *cache) {
+  return (cache->max_entries && cache->count > cache->max_entries) ||
+         (cache->max_bytes && cache->bytes > cache->max_bytes);
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+void splay_cache_init(struct splay_cache *cache, compare_func *func, enum splay_cache_policy policy,
+                      size_t max_entries, size_t max_bytes, splay_cache_evict_func *evict, void *arg) {
+  splay_tree_init(&cache->tree);
+  cache->func = func;
+  cache->policy = policy;
+  cache->head = cache->tail = NULL;
+  cache->count = cache->bytes = 0;
+  cache->max_entries = max_entries;
+  cache->max_bytes = max_bytes;
+  cache->random = 0x9e3779b97f4a7c15ull;
+  cache->evict = evict;
+  cache->arg = arg;
+}
+
+struct splay_cache_entry* splay_cache_get(struct splay_cache *cache, struct splay_node *query) {
+  struct splay_node *cur = splay_search(&cache->tree, query, cache->func);
+  if (!cur) return NULL;
+
+  struct splay_cache_entry *entry = _entry(cur);
+  if (cache->policy == SPLAY_CACHE_LRU && entry != cache->head) {
+    _lru_unlink(cache, entry);
+    _lru_push(cache, entry);
+  }
+  return entry;
+}
+
+void splay_cache_put(struct splay_cache *cache, struct splay_cache_entry *entry) {
+  struct splay_node *old = splay_search(&cache->tree, &entry->node, cache->func);
+  if (old == &entry->node) {
+    // the search splayed it up already, the list has to be told
+    cache->bytes += entry->charge - entry->charged;
+    if (cache->policy == SPLAY_CACHE_LRU && entry != cache->head) {
+      _lru_unlink(cache, entry);
+      _lru_push(cache, entry);
+    }
+  } else {
+    if (old) {
+      _remove(cache, _entry(old));
+      if (cache->evict) cache->evict(_entry(old), cache->arg);
+    }
+
+    splay_insert(&cache->tree, &entry->node, cache->func);
+    if (cache->policy == SPLAY_CACHE_LRU) _lru_push(cache, entry);
+    cache->count ++;
+    cache->bytes += entry->charge;
+  }
+  entry->charged = entry->charge;
+
+  while (_over_limit(cache) && cache->count > 1) {
+    struct splay_cache_entry *victim;
+    if (cache->policy == SPLAY_CACHE_LRU) {
+      victim = cache->tail;
+    } else {
+      victim = _deepest(cache);
+      if (victim == entry) {
+        // the new entry sits at the end of a path, drop one end of the order instead
+        struct splay_node *end = splay_first(&cache->tree);
+        victim = _entry(end != &entry->node ? end : splay_last(&cache->tree));
+      }
+    }
+    _remove(cache, victim);
+    if (cache->evict) cache->evict(victim, cache->arg);
+  }
+}
+
+struct splay_cache_entry* splay_cache_erase(struct splay_cache *cache, struct splay_node *query) {
+  struct splay_node *cur = splay_search(&cache->tree, query, cache->func);
+  if (!cur) return NULL;
+  _remove(cache, _entry(cur));
+  return _entry(cur);
+}
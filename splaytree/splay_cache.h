@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_CACHE
+#define _DUYNGUYEN_SPLAY_CACHE
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Bounded key-value cache on top of a splay tree
+ *
+ * Entries (the struct embedding splay_cache_entry) are found with splay_search(), which also
+ * keeps the hot ones near the root, and are evicted once the cache holds more than
+ * max_entries entries or max_bytes of their charge (0 for no limit). The victim is:
+ *
+ * - SPLAY_CACHE_LRU: the least recently used entry, from an intrusive list;
+ * - SPLAY_CACHE_DEEPEST: a leaf reached by a random walk down from the root. Splaying pulls
+ *   every accessed entry to the root, so leaves tend to be the ones not touched for long;
+ *   this saves the list update on every hit.
+ *
+ * The cache never frees memory: evicted and replaced entries go to the evict callback.
+ */
+enum splay_cache_policy {
+  SPLAY_CACHE_LRU,
+  SPLAY_CACHE_DEEPEST,
+};
+
+struct splay_cache_entry {
+  struct splay_node node;
+  struct splay_cache_entry *lru_prev, *lru_next;   // most recent first, SPLAY_CACHE_LRU only
+  size_t charge;
+  size_t charged;                                   // charge as counted in bytes, set by put
+};
+
+typedef void splay_cache_evict_func (struct splay_cache_entry *entry, void *arg);
+
+struct splay_cache {
+  struct splay_tree tree;
+  compare_func *func;
+  enum splay_cache_policy policy;
+  struct splay_cache_entry *head, *tail;
+  size_t count, bytes;
+  size_t max_entries, max_bytes;
+  uint64_t random;
+  splay_cache_evict_func *evict;
+  void *arg;
+};
+
+void splay_cache_init(struct splay_cache *cache, compare_func *func, enum splay_cache_policy policy,
+                      size_t max_entries, size_t max_bytes, splay_cache_evict_func *evict, void *arg);
+
+// entry equal to query, NULL on a miss
+struct splay_cache_entry* splay_cache_get(struct splay_cache *cache, struct splay_node *query);
+// adds entry with its charge set, in place of an equal one, then evicts down to the limits;
+// putting an entry that is cached already only takes its new charge and marks it as used
+void splay_cache_put(struct splay_cache *cache, struct splay_cache_entry *entry);
+// unlinks and returns the entry equal to query, the evict callback is not called
+struct splay_cache_entry* splay_cache_erase(struct splay_cache *cache, struct splay_node *query);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "splay_checkpoint.h"
+
+#define SPLAY_CHECKPOINT_MAGIC    0x594c5053u   // "SPLY"
+#define SPLAY_CHECKPOINT_VERSION  1
+
+struct splay_checkpoint_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t record_size;     // 0 for length-prefixed records
+};
+
+struct splay_checkpoint_trailer {
+  uint64_t count;
+  uint32_t magic;
+  uint32_t reserved;
+};
+
+struct _writer {
+  int fd;
+  char *buf;
+  size_t used;
+};
+
+INLINE int _writer_flush(struct _writer *w) {
+  size_t done = 0;
+  while (done < w->used) {
+    ssize_t ret = write(w->fd, w->buf + done, w->used - done);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    done += ret;
+  }
+  w->used = 0;
+  return 0;
+}
+
+// room for len bytes at the end of the buffer, flushing it if needed
+INLINE char *_writer_reserve(struct _writer *w, size_t len) {
+  if (len > SPLAY_CHECKPOINT_BUFFER) return NULL;
+  if (w->used + len > SPLAY_CHECKPOINT_BUFFER && _writer_flush(w) < 0) return NULL;
+  return w->buf + w->used;
+}
+
+INLINE int _write_record(struct _writer *w, struct splay_node *node, size_t record_size,
+                         splay_save_func *save, void *arg) {
+  size_t prefix = record_size ? 0 : sizeof(uint32_t), room, len;
+  char *dst = _writer_reserve(w, prefix);
+  if (!dst) return -1;
+
+  room = SPLAY_CHECKPOINT_BUFFER - w->used - prefix;
+  len = save(node, dst + prefix, room, arg);
+  if (len > room) {
+    // did not fit behind what is buffered, retry on an empty buffer
+    if (_writer_flush(w) < 0) return -1;
+    dst = w->buf;
+    room = SPLAY_CHECKPOINT_BUFFER - prefix;
+    len = save(node, dst + prefix, room, arg);
+    if (len > room) {
+      errno = EMSGSIZE;
+      return -1;
+    }
+  }
+  if (record_size && len != record_size) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  if (prefix) {
+    uint32_t len32 = (uint32_t) len;
+    memcpy(dst, &len32, sizeof(len32));
+  }
+  w->used += prefix + len;
+  return 0;
+}
+
+struct _reader {
+  const char *cur, *end;
+  size_t record_size;
+  splay_load_func *load;
+  void *arg;
+  uint64_t count;
+  bool failed;
+};
+
+static struct splay_node *_reader_next(void *arg) {
+  struct _reader *r = (struct _reader *) arg;
+  size_t len = r->record_size;
+  struct splay_node *node;
+
+  if (r->cur == r->end || r->failed) return NULL;
+  if (!len) {
+    uint32_t len32;
+    if ((size_t) (r->end - r->cur) < sizeof(len32)) goto damaged;
+    memcpy(&len32, r->cur, sizeof(len32));
+    r->cur += sizeof(len32);
+    len = len32;
+  }
+  if ((size_t) (r->end - r->cur) < len) goto damaged;
+
+  node = r->load(r->cur, len, r->arg);
+  if (!node) {
+    r->failed = true;
+    return NULL;
+  }
+  r->cur += len;
+  r->count ++;
+  return node;
+
+damaged:
+  r->failed = true;
+  return NULL;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+int splay_checkpoint(struct splay_tree *tree, compare_func *func, int fd, size_t record_size,
+                     splay_save_func *save, void *arg) {
+  struct splay_checkpoint_header header = { SPLAY_CHECKPOINT_MAGIC, SPLAY_CHECKPOINT_VERSION, record_size };
+  struct splay_checkpoint_trailer trailer = { 0, SPLAY_CHECKPOINT_MAGIC, 0 };
+  struct _writer w = { fd, (char *) malloc(SPLAY_CHECKPOINT_BUFFER), 0 };
+  struct splay_node *cur;
+  char *dst;
+  int ret = -1;
+
+  if (!w.buf) return -1;
+  memcpy(_writer_reserve(&w, sizeof(header)), &header, sizeof(header));
+  w.used += sizeof(header);
+
+  for(cur = splay_first(tree); cur; cur = splay_next(tree, cur, func)) {
+    if (_write_record(&w, cur, record_size, save, arg) < 0) goto out;
+    trailer.count ++;
+  }
+
+  dst = _writer_reserve(&w, sizeof(trailer));
+  if (!dst) goto out;
+  memcpy(dst, &trailer, sizeof(trailer));
+  w.used += sizeof(trailer);
+  ret = _writer_flush(&w);
+
+out:
+  free(w.buf);
+  return ret;
+}
+
+int splay_restore(struct splay_tree *tree, int fd, splay_load_func *load, void *arg) {
+  struct splay_checkpoint_header header;
+  struct splay_checkpoint_trailer trailer;
+  struct stat st;
+  char *base;
+
+  if (fstat(fd, &st) < 0) return -1;
+  if ((size_t) st.st_size < sizeof(header) + sizeof(trailer)) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  base = (char *) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (base == MAP_FAILED) return -1;
+  madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+  memcpy(&header, base, sizeof(header));
+  memcpy(&trailer, base + st.st_size - sizeof(trailer), sizeof(trailer));
+  struct _reader r = { base + sizeof(header), base + st.st_size - sizeof(trailer),
+                       header.record_size, load, arg, 0, false };
+
+  if (header.magic != SPLAY_CHECKPOINT_MAGIC || header.version != SPLAY_CHECKPOINT_VERSION ||
+      trailer.magic != SPLAY_CHECKPOINT_MAGIC ||
+      (header.record_size && (size_t) (r.end - r.cur) != trailer.count * header.record_size)) {
+    munmap(base, st.st_size);
+    errno = EINVAL;
+    return -1;
+  }
+
+  splay_build(tree, _reader_next, &r);
+  munmap(base, st.st_size);
+
+  if (r.failed || r.count != trailer.count) {
+    errno = EINVAL;
+    return -1;
+  }
+  return 0;
+}
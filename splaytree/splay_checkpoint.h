@@ -0,0 +1,69 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_CHECKPOINT
+#define _DUYNGUYEN_SPLAY_CHECKPOINT
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Streaming checkpoint and linear-time restore
+ *
+ * splay_checkpoint() writes the nodes in order to a file descriptor, a pipe or socket will
+ * do, as one record each: record_size bytes when record_size is not 0, otherwise a 32-bit
+ * length followed by the record. The save callback fills a record in buf and returns its
+ * length; a return larger than len asks again with a fresh buffer of SPLAY_CHECKPOINT_BUFFER.
+ *
+ * splay_restore() maps a checkpoint file and links the nodes made by the load callback,
+ * in file order, into an empty tree with splay_build(), so no comparison is made. The
+ * record is only mapped during the callback. If the file is damaged or load returns NULL,
+ * the nodes made so far are still linked into the tree for the caller to release.
+ *
+ * The file is a header (magic, version, record size), the records, then a trailer with the
+ * record count, all in host byte order.
+ */
+#ifndef SPLAY_CHECKPOINT_BUFFER
+#define SPLAY_CHECKPOINT_BUFFER (1 << 20)
+#endif
+
+typedef size_t splay_save_func (struct splay_node *node, void *buf, size_t len, void *arg);
+typedef struct splay_node *splay_load_func (const void *record, size_t len, void *arg);
+
+int splay_checkpoint(struct splay_tree *tree, compare_func *func, int fd, size_t record_size,
+                     splay_save_func *save, void *arg);
+int splay_restore(struct splay_tree *tree, int fd, splay_load_func *load, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "splay_interval.h"
+
+#ifdef _SPLAY_AUGMENT
+
+#define _interval(p)  _get_entry(p, struct splay_interval, node)
+
+// enough for the depth of any tree of a few thousand nodes, deeper ones go to the heap
+#define SPLAY_INTERVAL_STACK 64
+
+static int _interval_compare(struct splay_node *a, struct splay_node *b) {
+  struct splay_interval *aa = _interval(a), *bb = _interval(b);
+  if (aa->start != bb->start) return aa->start < bb->start ? -1 : 1;
+  if (aa->end != bb->end) return aa->end < bb->end ? -1 : 1;
+  if (aa == bb) return 0;
+  return aa < bb ? -1 : 1;
+}
+
+static void _interval_update(struct splay_node *node) {
+  struct splay_interval *cur = _interval(node);
+  struct splay_node *left = splay_left(node), *right = splay_right(node);
+  cur->max_end = cur->end;
+  if (left && _interval(left)->max_end > cur->max_end) cur->max_end = _interval(left)->max_end;
+  if (right && _interval(right)->max_end > cur->max_end) cur->max_end = _interval(right)->max_end;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+void splay_interval_init(struct splay_tree *tree) {
+  splay_tree_init_augmented(tree, _interval_update);
+}
+
+void splay_interval_insert(struct splay_tree *tree, struct splay_interval *interval) {
+  splay_insert(tree, &interval->node, _interval_compare);
+}
+
+void splay_interval_delete(struct splay_tree *tree, struct splay_interval *interval) {
+  splay_delete(tree, &interval->node, _interval_compare);
+}
+
+size_t splay_interval_overlap(struct splay_tree *tree, uint64_t lo, uint64_t hi,
+                              splay_interval_func *func, void *arg) {
+  struct splay_node *local[SPLAY_INTERVAL_STACK], **stack = local, *cur;
+  size_t depth = 0, capacity = SPLAY_INTERVAL_STACK, count = 0;
+  struct splay_interval query;
+
+  if (lo >= hi) return 0;
+  // sorts before every interval starting at hi
+  query.start = hi;
+  query.end = 0;
+  splay_search_greater(tree, &query.node, _interval_compare);
+  if (!tree->root) {
+#ifdef _SPLAY_SMALL_TREE
+    // a small tree is an array, sorted by start
+    size_t pos;
+    for(pos = 0; pos < tree->count && _interval(tree->small[pos])->start < hi; pos ++) {
+      if (_interval(tree->small[pos])->end <= lo) continue;
+      count ++;
+      if (!func(_interval(tree->small[pos]), arg)) break;
+    }
+#endif
+    return count;
+  }
+
+  // in-order walk, pruned on max_end and stopped at the first start >= hi
+  cur = tree->root;
+  for (;;) {
+    for(; cur && _interval(cur)->max_end > lo; cur = splay_left(cur)) {
+      if (depth == capacity) {
+        struct splay_node **grown = (struct splay_node **) malloc(2 * capacity * sizeof(*grown));
+        if (!grown) {
+          count = SPLAY_INTERVAL_ERROR;
+          goto out;
+        }
+        memcpy(grown, stack, depth * sizeof(*grown));
+        if (stack != local) free(stack);
+        stack = grown;
+        capacity *= 2;
+      }
+      stack[depth ++] = cur;
+    }
+    if (!depth) break;
+
+    cur = stack[-- depth];
+    if (_interval(cur)->start >= hi) break;
+    if (_interval(cur)->end > lo) {
+      count ++;
+      if (!func(_interval(cur), arg)) break;
+    }
+    cur = splay_right(cur);
+  }
+
+out:
+  if (stack != local) free(stack);
+  return count;
+}
+
+#endif /* _SPLAY_AUGMENT */
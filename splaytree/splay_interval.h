@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_INTERVAL
+#define _DUYNGUYEN_SPLAY_INTERVAL
+
+#include "splaytree.h"
+
+#ifdef _SPLAY_AUGMENT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Interval tree of half-open [start, end) ranges, built on _SPLAY_AUGMENT
+ *
+ * Intervals are ordered by start (then end, then address, so equal ones can coexist) and
+ * every node keeps the largest end of its subtree, maintained by the update hook through
+ * rotations and the top-down assembly. splay_interval_overlap() splays the first interval
+ * starting at or after hi to the root and then walks in order what is left of it, skipping
+ * every subtree whose max_end is not past lo: it touches the reported intervals and the
+ * paths to them, not the other intervals that start before hi.
+ */
+struct splay_interval {
+  struct splay_node node;
+  uint64_t start, end;
+  uint64_t max_end;       // of the subtree
+};
+
+// false stops the enumeration
+typedef bool splay_interval_func (struct splay_interval *interval, void *arg);
+
+void splay_interval_init(struct splay_tree *tree);
+void splay_interval_insert(struct splay_tree *tree, struct splay_interval *interval);
+void splay_interval_delete(struct splay_tree *tree, struct splay_interval *interval);
+
+// returned by splay_interval_overlap when it could not grow its walk stack, func may have
+// been called on some of the intervals already
+#define SPLAY_INTERVAL_ERROR ((size_t) -1)
+
+// calls func in start order on the intervals overlapping [lo, hi), returns how many
+size_t splay_interval_overlap(struct splay_tree *tree, uint64_t lo, uint64_t hi,
+                              splay_interval_func *func, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SPLAY_AUGMENT */
+
+#endif
@@ -0,0 +1,334 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "splay_parallel.h"
+
+// what a missing child stores, as in splaytree.c
+#ifdef _SPLAY_THREADED
+#define _thread(p)  ((struct splay_node *) ((uintptr_t) (p) | 1))
+#else
+#define _thread(p)  NULL
+#endif
+
+/**
+ * @brief    Jobs
+ *
+ * _run_jobs() runs count jobs of size bytes each, all but the last on new threads and the
+ * last on the calling one. A job whose thread cannot be started runs in place, so a short
+ * supply of threads only costs time.
+ */
+typedef void *_job_func (void *job);
+
+static void _run_jobs(_job_func *run, void *jobs, size_t size, size_t count) {
+  pthread_t local[32], *threads = local;
+  bool started[32], *ok = started;
+  size_t idx;
+  if (count > 32) {
+    threads = (pthread_t *) malloc(count * (sizeof(pthread_t) + sizeof(bool)));
+    ok = threads ? (bool *) (threads + count) : NULL;
+  }
+  for(idx = 0; idx + 1 < count; idx ++) {
+    void *job = (int8_t *) jobs + idx * size;
+    if (!threads || !(ok[idx] = pthread_create(&threads[idx], NULL, run, job) == 0)) run(job);
+  }
+  if (count) run((int8_t *) jobs + (count - 1) * size);
+  for(idx = 0; threads && idx + 1 < count; idx ++) {
+    if (ok[idx]) pthread_join(threads[idx], NULL);
+  }
+  if (threads != local) free(threads);
+}
+
+/**
+ * @brief    Sort
+ *
+ * Every thread merge sorts its chunk, then the runs are merged pairwise, level by level.
+ * A merge is cut into pieces along the merge path (Odeh et al.), so all threads stay busy
+ * until the last level. Ties go to the left run, which keeps the sort stable.
+ */
+struct _merge_job {
+  struct splay_node **x, **y, **out;
+  size_t nx, ny;
+  compare_func *func;
+};
+
+INLINE void _merge(struct splay_node **x, size_t nx, struct splay_node **y, size_t ny,
+                   struct splay_node **out, compare_func *func) {
+  while (nx && ny) {
+    if (func(*y, *x) < 0) {
+      *out ++ = *y ++;
+      ny --;
+    } else {
+      *out ++ = *x ++;
+      nx --;
+    }
+  }
+  memcpy(out, x, nx * sizeof(struct splay_node *));
+  memcpy(out + nx, y, ny * sizeof(struct splay_node *));
+}
+
+INLINE void _insertion_sort(struct splay_node **a, size_t n, compare_func *func) {
+  size_t i, j;
+  for(i = 1; i < n; i ++) {
+    struct splay_node *cur = a[i];
+    for(j = i; j && func(a[j - 1], cur) > 0; j --) {
+      a[j] = a[j - 1];
+    }
+    a[j] = cur;
+  }
+}
+
+// a and b hold the same nodes, they end up sorted in b with a as scratch
+static void _merge_sort(struct splay_node **a, struct splay_node **b, size_t n, compare_func *func) {
+  size_t half = n / 2;
+  if (n <= 16) {
+    _insertion_sort(b, n, func);
+    return;
+  }
+  _merge_sort(b, a, half, func);
+  _merge_sort(b + half, a + half, n - half, func);
+  _merge(a, half, a + half, n - half, b, func);
+}
+
+static void *_sort_chunk(void *arg) {
+  struct _merge_job *job = (struct _merge_job *) arg;
+  memcpy(job->x, job->out, job->nx * sizeof(struct splay_node *));
+  _merge_sort(job->x, job->out, job->nx, job->func);
+  return NULL;
+}
+
+static void *_merge_piece(void *arg) {
+  struct _merge_job *job = (struct _merge_job *) arg;
+  _merge(job->x, job->nx, job->y, job->ny, job->out, job->func);
+  return NULL;
+}
+
+// how many of the first d merged nodes come from x
+INLINE size_t _merge_path(struct splay_node **x, size_t nx, struct splay_node **y, size_t ny,
+                          size_t d, compare_func *func) {
+  size_t lo = d > ny ? d - ny : 0, hi = d < nx ? d : nx, mid;
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (func(x[mid], y[d - mid - 1]) <= 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// sorts nodes with tmp as scratch, returns the one of the two holding the result
+static struct splay_node **_parallel_sort(struct splay_node **nodes, struct splay_node **tmp,
+                                          size_t count, compare_func *func, size_t threads,
+                                          struct _merge_job *jobs, size_t *bounds) {
+  struct splay_node **src = nodes, **dst = tmp, **swap;
+  size_t runs = threads, idx, piece, pieces, jobCount;
+
+  for(idx = 0; idx <= runs; idx ++) {
+    bounds[idx] = count * idx / runs;
+  }
+  for(idx = 0; idx < runs; idx ++) {
+    jobs[idx].x = tmp + bounds[idx];
+    jobs[idx].out = nodes + bounds[idx];
+    jobs[idx].nx = bounds[idx + 1] - bounds[idx];
+    jobs[idx].func = func;
+  }
+  _run_jobs(_sort_chunk, jobs, sizeof(struct _merge_job), runs);
+
+  while (runs > 1) {
+    pieces = threads / ((runs + 1) / 2);
+    if (!pieces) pieces = 1;
+    jobCount = 0;
+    for(idx = 0; idx < runs; idx += 2) {
+      // an odd run out is a merge with an empty one, a copy
+      struct splay_node **x = src + bounds[idx], **y = src + bounds[idx + 1];
+      size_t nx = bounds[idx + 1] - bounds[idx];
+      size_t ny = idx + 1 < runs ? bounds[idx + 2] - bounds[idx + 1] : 0;
+      size_t from = 0, fromX = 0;
+      for(piece = 1; piece <= pieces; piece ++) {
+        size_t to = (nx + ny) * piece / pieces;
+        size_t toX = _merge_path(x, nx, y, ny, to, func);
+        struct _merge_job *job = &jobs[jobCount ++];
+        job->x = x + fromX;
+        job->nx = toX - fromX;
+        job->y = y + (from - fromX);
+        job->ny = (to - toX) - (from - fromX);
+        job->out = dst + bounds[idx] + from;
+        job->func = func;
+        from = to;
+        fromX = toX;
+      }
+    }
+    _run_jobs(_merge_piece, jobs, sizeof(struct _merge_job), jobCount);
+
+    for(idx = 0; 2 * idx < runs; idx ++) {
+      bounds[idx] = bounds[2 * idx];
+    }
+    bounds[idx] = count;
+    runs = idx;
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+  return src;
+}
+
+/**
+ * @brief    Link
+ *
+ * The middle of a sorted range is the root of its subtree and everything it links to is
+ * known from the indexes alone: children, order neighbours, threads. The top levels hand
+ * their left subtree to a new thread.
+ */
+struct _link_job {
+  struct splay_node **nodes;
+  size_t lo, hi, count;
+  int spawn;
+#ifdef _SPLAY_AUGMENT
+  splay_update_func *update;
+#endif
+  struct splay_node *root;
+};
+
+static void *_link(void *arg) {
+  struct _link_job *job = (struct _link_job *) arg, sub[2];
+  struct splay_node **nodes = job->nodes;
+  size_t mid = job->lo + (job->hi - job->lo) / 2;
+  struct splay_node *root = nodes[mid];
+
+  sub[0] = sub[1] = *job;
+  sub[0].hi = mid;
+  sub[1].lo = mid + 1;
+  sub[0].spawn = sub[1].spawn = job->spawn - 1;
+  if (job->spawn > 0 && job->hi - job->lo > SPLAY_PARALLEL_GRAIN) {
+    _run_jobs(_link, sub, sizeof(struct _link_job), 2);
+  } else {
+    if (job->lo < mid) _link(&sub[0]);
+    if (mid + 1 < job->hi) _link(&sub[1]);
+  }
+
+#if defined(_SPLAY_THREADED) || defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_XOR_SIBLING)
+  struct splay_node *prev = mid ? nodes[mid - 1] : NULL;
+  struct splay_node *next = mid + 1 < job->count ? nodes[mid + 1] : NULL;
+#endif
+  root->left = job->lo < mid ? sub[0].root : _thread(prev);
+  root->right = mid + 1 < job->hi ? sub[1].root : _thread(next);
+#ifdef _SPLAY_SIBLING_POINTER
+  root->prev = prev;
+  root->next = next;
+#endif
+#ifdef _SPLAY_XOR_SIBLING
+  root->sibling = (uintptr_t) prev ^ (uintptr_t) next;
+#endif
+#ifdef _SPLAY_AUGMENT
+  if (job->update) job->update(root);
+#endif
+  job->root = root;
+  return NULL;
+}
+
+// feeds splay_build() from the array
+struct _array_source {
+  struct splay_node **nodes;
+  size_t pos, count;
+};
+
+static struct splay_node *_array_next(void *arg) {
+  struct _array_source *source = (struct _array_source *) arg;
+  return source->pos < source->count ? source->nodes[source->pos ++] : NULL;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+int splay_build_parallel(struct splay_tree *tree, struct splay_node **nodes, size_t count,
+                         compare_func *func, int threads, size_t *unique) {
+  struct splay_node **tmp, **sorted;
+  struct _merge_job *jobs;
+  size_t *bounds, total, dups = 0, idx;
+  int spawn = 0;
+
+  // no more threads than pieces of work worth one
+  total = threads > 1 ? (size_t) threads : 1;
+  if (total > count / SPLAY_PARALLEL_GRAIN) total = count / SPLAY_PARALLEL_GRAIN;
+  if (!total) total = 1;
+
+  tmp = (struct splay_node **) malloc(count * sizeof(struct splay_node *) +
+                                      2 * total * sizeof(struct _merge_job) +
+                                      (total + 1) * sizeof(size_t) + 1);
+  if (!tmp) return -1;
+  jobs = (struct _merge_job *) (tmp + count);
+  bounds = (size_t *) (jobs + 2 * total);
+
+  sorted = _parallel_sort(nodes, tmp, count, func, total, jobs, bounds);
+
+  // the first of every run of equal nodes stays, the others are collected in tmp; both
+  // writes trail the read, whichever array holds the sorted nodes
+  *unique = 0;
+  for(idx = 0; idx < count; idx ++) {
+    struct splay_node *cur = sorted[idx];
+    if (*unique && func(nodes[*unique - 1], cur) == 0) {
+      tmp[dups ++] = cur;
+    } else {
+      nodes[(*unique) ++] = cur;
+    }
+  }
+  memmove(nodes + *unique, tmp, dups * sizeof(struct splay_node *));
+  free(tmp);
+
+  if (*unique < SPLAY_PARALLEL_GRAIN) {
+    struct _array_source source = {nodes, 0, *unique};
+    splay_build(tree, _array_next, &source);
+    return 0;
+  }
+
+  struct _link_job job;
+  while (spawn < 31 && ((size_t) 1 << spawn) < total) spawn ++;
+  job.nodes = nodes;
+  job.lo = 0;
+  job.hi = job.count = *unique;
+  job.spawn = spawn;
+#ifdef _SPLAY_AUGMENT
+  job.update = tree->update;
+#endif
+  _link(&job);
+  tree->root = job.root;
+#ifdef _SPLAY_SMALL_TREE
+  tree->count = *unique;
+#endif
+  return 0;
+}
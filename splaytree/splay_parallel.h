@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_PARALLEL
+#define _DUYNGUYEN_SPLAY_PARALLEL
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Parallel bulk build from unsorted nodes
+ *
+ * splay_build_parallel() sorts the node pointers with a merge sort spread over threads
+ * (pthreads), keeps the first of every run of equal nodes, and links the rest into the empty
+ * tree as a balanced tree, order links included, one subtree per thread. The sort is stable
+ * and the input order decides which duplicate wins.
+ *
+ * On return nodes[0..*unique) are the linked nodes in ascending order and the duplicates
+ * that were left out follow them, for the caller to release. It needs a scratch array of
+ * count pointers; if that cannot be allocated it returns -1 with the tree and nodes untouched.
+ */
+#ifndef SPLAY_PARALLEL_GRAIN
+// below this many nodes a piece of work is not handed to a new thread
+#define SPLAY_PARALLEL_GRAIN (1 << 14)
+#endif
+
+int splay_build_parallel(struct splay_tree *tree, struct splay_node **nodes, size_t count,
+                         compare_func *func, int threads, size_t *unique);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "splay_pool.h"
+
+#define SPLAY_POOL_HUGE_PAGE (2UL << 20)
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+
+static char *_pool_map(size_t length, int extra) {
+  void *addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+  return addr == MAP_FAILED ? NULL : (char *) addr;
+}
+
+// a plain mapping starting on a huge page boundary, so that THP can back all of it
+static char *_pool_map_aligned(size_t length) {
+  char *addr = _pool_map(length + SPLAY_POOL_HUGE_PAGE, MAP_NORESERVE), *aligned;
+  if (!addr) return NULL;
+  aligned = (char *) (((uintptr_t) addr + SPLAY_POOL_HUGE_PAGE - 1) & ~(SPLAY_POOL_HUGE_PAGE - 1));
+  if (aligned > addr) munmap(addr, aligned - addr);
+  munmap(aligned + length, addr + SPLAY_POOL_HUGE_PAGE - aligned);
+  return aligned;
+}
+
+static int _pool_bind(char *addr, size_t length, int numa_node) {
+#ifdef SYS_mbind
+  unsigned long mask[16] = { 0 };
+  if (numa_node < 0 || numa_node >= (int) (8 * sizeof(mask))) return -1;
+  mask[numa_node / (8 * sizeof(unsigned long))] = 1UL << (numa_node % (8 * sizeof(unsigned long)));
+  return syscall(SYS_mbind, addr, length, MPOL_BIND, mask, 8 * sizeof(mask), 0) == 0 ? 0 : -1;
+#else
+  return -1;
+#endif
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+int splay_pool_init(struct splay_pool *pool, size_t object_size, size_t capacity, int numa_node, int flags) {
+  // objects hold the free list link and keep the node pointers aligned
+  if (object_size < sizeof(void *)) object_size = sizeof(void *);
+  object_size = (object_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+  pool->object_size = object_size;
+  pool->capacity = capacity;
+  pool->used = 0;
+  pool->free_list = NULL;
+  pool->backing = SPLAY_POOL_PAGES;
+  pool->numa_node = -1;
+  pool->length = (object_size * capacity + SPLAY_POOL_HUGE_PAGE - 1) & ~(SPLAY_POOL_HUGE_PAGE - 1);
+  pool->base = NULL;
+  if (!pool->length) return -1;
+
+#ifdef MAP_HUGETLB
+  if (flags & SPLAY_POOL_HUGE) {
+    // no MAP_NORESERVE here: the huge pages must be reserved now rather than fault with SIGBUS later
+    pool->base = _pool_map(pool->length, MAP_HUGETLB);
+    if (pool->base) pool->backing = SPLAY_POOL_HUGETLB;
+  }
+#endif
+  if (!pool->base) {
+    pool->base = (flags & SPLAY_POOL_HUGE) ? _pool_map_aligned(pool->length)
+                                           : _pool_map(pool->length, MAP_NORESERVE);
+    if (!pool->base) return -1;
+#ifdef MADV_HUGEPAGE
+    if ((flags & SPLAY_POOL_HUGE) && madvise(pool->base, pool->length, MADV_HUGEPAGE) == 0) {
+      pool->backing = SPLAY_POOL_THP;
+    }
+#endif
+  }
+
+  if (numa_node >= 0 && _pool_bind(pool->base, pool->length, numa_node) == 0) {
+    pool->numa_node = numa_node;
+  }
+  return 0;
+}
+
+void splay_pool_destroy(struct splay_pool *pool) {
+  if (pool->base) munmap(pool->base, pool->length);
+  pool->base = NULL;
+  pool->length = pool->capacity = pool->used = 0;
+  pool->free_list = NULL;
+}
+
+void *splay_pool_alloc(struct splay_pool *pool) {
+  void *object = pool->free_list;
+  if (object) {
+    pool->free_list = *(void **) object;
+    return object;
+  }
+  if (pool->used == pool->capacity) return NULL;
+  return pool->base + pool->object_size * pool->used ++;
+}
+
+void splay_pool_release(struct splay_pool *pool, void *object) {
+  *(void **) object = pool->free_list;
+  pool->free_list = object;
+}
@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_POOL
+#define _DUYNGUYEN_SPLAY_POOL
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Fixed-capacity pool for objects embedding a splay node
+ *
+ * One mapping holds every object, so a big tree covers as few pages as possible. With
+ * SPLAY_POOL_HUGE the pool asks for 2MB pages, first as MAP_HUGETLB, then as a 2MB aligned
+ * mapping marked MADV_HUGEPAGE for transparent huge pages, and finally settles for plain
+ * pages. A numa_node >= 0 binds the mapping to that node with mbind(2) before anything is
+ * touched. Whatever could not be honoured is reported in backing / numa_node, never failed.
+ *
+ * Pages are only committed when objects are first handed out, released objects are reused.
+ */
+enum splay_pool_flags {
+  SPLAY_POOL_HUGE = 1,
+};
+
+enum splay_pool_backing {
+  SPLAY_POOL_PAGES = 0,     // base pages
+  SPLAY_POOL_THP = 1,       // transparent huge pages requested with madvise
+  SPLAY_POOL_HUGETLB = 2,   // reserved huge pages
+};
+
+struct splay_pool {
+  char *base;
+  size_t length;            // of the mapping
+  size_t object_size;
+  size_t capacity;
+  size_t used;              // objects handed out at least once
+  void *free_list;          // released objects, chained through their first word
+  enum splay_pool_backing backing;
+  int numa_node;            // node the memory is bound to, -1 if none
+};
+
+int splay_pool_init(struct splay_pool *pool, size_t object_size, size_t capacity, int numa_node, int flags);
+void splay_pool_destroy(struct splay_pool *pool);
+
+// NULL when all capacity objects are in use
+void *splay_pool_alloc(struct splay_pool *pool);
+void splay_pool_release(struct splay_pool *pool, void *object);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include "splay_pq.h"
+
+#ifdef _SPLAY_SIBLING_POINTER
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+void splay_pq_init(struct splay_pq *pq, compare_func *func) {
+  splay_tree_init(&pq->tree);
+  pq->func = func;
+  pq->min = NULL;
+  pq->count = 0;
+}
+
+bool splay_pq_push(struct splay_pq *pq, struct splay_node *node) {
+  // a queued node has a neighbour or is the only one, inserting it again would reset its links
+  if (node == pq->min || node->prev || node->next) return false;
+  // next to other nodes a linked node has a neighbour, one left out of the chain has none
+  splay_insert(&pq->tree, node, pq->func);
+  if (pq->count && !node->prev && !node->next) return false;
+  if (!node->prev) pq->min = node;
+  pq->count ++;
+  return true;
+}
+
+struct splay_node* splay_pq_pop_min(struct splay_pq *pq) {
+  struct splay_node *min = pq->min;
+  if (!min) return NULL;
+  pq->min = min->next;
+  splay_pop_first(&pq->tree);
+  pq->count --;
+  return min;
+}
+
+void splay_pq_cancel(struct splay_pq *pq, struct splay_node *node) {
+  if (node == pq->min) {
+    splay_pq_pop_min(pq);
+    return;
+  }
+  splay_delete(&pq->tree, node, pq->func);
+  pq->count --;
+}
+
+#endif /* _SPLAY_SIBLING_POINTER */
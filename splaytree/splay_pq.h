@@ -0,0 +1,79 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_PQ
+#define _DUYNGUYEN_SPLAY_PQ
+
+#include "splaytree.h"
+
+#ifdef _SPLAY_SIBLING_POINTER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Priority queue (timer queue) on top of a splay tree, built on _SPLAY_SIBLING_POINTER
+ *
+ * The minimum is cached and kept current through the prev / next chain, so peeking is O(1)
+ * and popping unlinks it with a splay down the left spine that never calls the comparator.
+ * A pushed node is its own handle: splay_pq_cancel() removes it from anywhere in the queue.
+ *
+ * func has to order every pair of distinct nodes (compare the addresses last to allow equal
+ * deadlines), a node comparing equal to one already queued is not pushed. A node that is not
+ * queued has NULL prev and next: zero it before its first push, pop and cancel leave it so.
+ */
+struct splay_pq {
+  struct splay_tree tree;
+  compare_func *func;
+  struct splay_node *min;
+  size_t count;
+};
+
+void splay_pq_init(struct splay_pq *pq, compare_func *func);
+
+// false if node or an equal one is already queued
+bool splay_pq_push(struct splay_pq *pq, struct splay_node *node);
+
+static inline struct splay_node *splay_pq_peek_min(struct splay_pq *pq) {
+  return pq->min;
+}
+
+// NULL when the queue is empty
+struct splay_node* splay_pq_pop_min(struct splay_pq *pq);
+
+// node has to be queued in pq
+void splay_pq_cancel(struct splay_pq *pq, struct splay_node *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SPLAY_SIBLING_POINTER */
+
+#endif
@@ -0,0 +1,173 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <string.h>
+
+#include "splay_rel.h"
+
+#define _rel_align(n)  (((n) + 15) & ~(uint64_t) 15)
+
+// the offset instance of the template: the links are turned into pointers and back against
+// the base of the region, prev / next are always kept, and the names are its own
+#undef _SPLAY_AUGMENT
+#undef _SPLAY_THREADED
+#undef _SPLAY_XOR_SIBLING
+#undef _SPLAY_INSERT_RANDOM
+#ifndef _SPLAY_SIBLING_POINTER
+#define _SPLAY_SIBLING_POINTER
+#endif
+#define _SPLAY_NODE             struct splay_rel_node
+#define _SPLAY_TREE             struct splay_rel
+#define _SPLAY_FUNC             splay_rel_compare_func
+#define _SPLAY_CMP(node, query) func(node, query)
+
+#define _SPLAY_LINK_ACCESS
+#define _left(p)              splay_rel_ptr(tree, (p)->left)
+#define _right(p)             splay_rel_ptr(tree, (p)->right)
+#define _prev(p)              splay_rel_ptr(tree, (p)->prev)
+#define _next(p)              splay_rel_ptr(tree, (p)->next)
+#define _root(t)              splay_rel_ptr(t, (t)->header->root)
+#define _set_left(p, v)       ((p)->left = splay_rel_offset(tree, v))
+#define _set_right(p, v)      ((p)->right = splay_rel_offset(tree, v))
+#define _set_prev(p, v)       ((p)->prev = splay_rel_offset(tree, v))
+#define _set_next(p, v)       ((p)->next = splay_rel_offset(tree, v))
+#define _set_root(t, v)       ((t)->header->root = splay_rel_offset(t, v))
+
+#define _right_rotate         _right_rotate_rel
+#define _left_rotate          _left_rotate_rel
+#define _leftmost             _leftmost_rel
+#define _rightmost            _rightmost_rel
+#define _pred                 _pred_rel
+#define _succ                 _succ_rel
+#define _init_splay_node      _init_splay_node_rel
+#define _bias_cmp             _bias_cmp_rel
+#define _splay_bias           _splay_bias_rel
+#define _splay                _splay_rel
+#define _link_root            _link_root_rel
+#define _tree_insert          _tree_insert_rel
+#define _unlink_root          _unlink_root_rel
+#define _tree_delete          _tree_delete_rel
+#define _tree_prev            _tree_prev_rel
+#define _tree_next            _tree_next_rel
+#define _tree_search          _tree_search_rel
+#define _tree_search_lower    _tree_search_lower_rel
+#define _tree_search_greater  _tree_search_greater_rel
+#define _tree_first           _tree_first_rel
+#define _tree_last            _tree_last_rel
+
+#include "splaytree.inc"
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+int splay_rel_init(struct splay_rel *rel, void *base, size_t size) {
+  if (size < _rel_align(sizeof(struct splay_rel_header))) return -1;
+  rel->base = (char *) base;
+  rel->header = (struct splay_rel_header *) base;
+  memset(rel->header, 0, sizeof(struct splay_rel_header));
+  rel->header->magic = SPLAY_REL_MAGIC;
+  rel->header->version = SPLAY_REL_VERSION;
+  rel->header->size = size;
+  rel->header->used = _rel_align(sizeof(struct splay_rel_header));
+  return 0;
+}
+
+int splay_rel_attach(struct splay_rel *rel, void *base, size_t size) {
+  struct splay_rel_header *header = (struct splay_rel_header *) base;
+  if (size < sizeof(struct splay_rel_header) ||
+      header->magic != SPLAY_REL_MAGIC || header->version != SPLAY_REL_VERSION ||
+      header->size > size || header->used > header->size) {
+    return -1;
+  }
+  rel->base = (char *) base;
+  rel->header = header;
+  return 0;
+}
+
+void *splay_rel_alloc(struct splay_rel *rel, size_t size) {
+  struct splay_rel_header *header = rel->header;
+  if (size > header->size - header->used) return NULL;
+  void *ptr = rel->base + header->used;
+  header->used += _rel_align(size);
+  if (header->used > header->size) header->used = header->size;
+  return ptr;
+}
+
+void splay_rel_insert(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  if (_tree_insert(rel, node, func)) rel->header->count ++;
+}
+
+void splay_rel_delete(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  if (_tree_delete(rel, node, func)) rel->header->count --;
+}
+
+struct splay_rel_node* splay_rel_search(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  return _tree_search(rel, node, func);
+}
+
+struct splay_rel_node* splay_rel_search_lower(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  return _tree_search_lower(rel, node, func);
+}
+
+struct splay_rel_node* splay_rel_search_greater(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  return _tree_search_greater(rel, node, func);
+}
+
+struct splay_rel_node* splay_rel_find(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func) {
+  struct splay_rel_node *cur = splay_rel_ptr(rel, rel->header->root);
+  while (cur) {
+    int cmp = func(cur, node);
+    if (cmp == 0) return cur;
+    cur = splay_rel_ptr(rel, (cmp > 0) ? cur->left : cur->right);
+  }
+  return NULL;
+}
+
+struct splay_rel_node* splay_rel_first(struct splay_rel *rel) {
+  return _tree_first(rel);
+}
+
+struct splay_rel_node* splay_rel_last(struct splay_rel *rel) {
+  return _tree_last(rel);
+}
+
+struct splay_rel_node* splay_rel_prev(struct splay_rel *rel, struct splay_rel_node *node) {
+  return splay_rel_ptr(rel, node->prev);
+}
+
+struct splay_rel_node* splay_rel_next(struct splay_rel *rel, struct splay_rel_node *node) {
+  return splay_rel_ptr(rel, node->next);
+}
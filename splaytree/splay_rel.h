@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_REL
+#define _DUYNGUYEN_SPLAY_REL
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Relocatable splay tree living in one memory region
+ *
+ * Every link is an offset from the start of the region, 0 standing for NULL, so the region
+ * can be a file mapped at any address, a memfd / shm_open segment shared by several
+ * processes, or simply copied. The region starts with a header recording the layout version,
+ * the root and a bump allocator; nodes (the struct embedding splay_rel_node) are carved out
+ * of it with splay_rel_alloc().
+ *
+ * struct splay_rel is the per-process handle: splay_rel_init() formats a region,
+ * splay_rel_attach() adopts one formatted by another process or an earlier run. The searches
+ * splay like the pointer-based tree and so write to the region; concurrent users either hold
+ * a lock or stick to splay_rel_find(), which does not restructure.
+ */
+#define SPLAY_REL_MAGIC    0x4c455253u    // "SREL"
+#define SPLAY_REL_VERSION  1
+
+struct splay_rel_node {
+  uint64_t left, right;
+  uint64_t prev, next;
+};
+
+struct splay_rel_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t size;        // bytes of the region
+  uint64_t used;        // bytes handed out, header included
+  uint64_t root;
+  uint64_t count;
+};
+
+struct splay_rel {
+  char *base;
+  struct splay_rel_header *header;
+};
+
+typedef int splay_rel_compare_func (struct splay_rel_node *a, struct splay_rel_node *b);
+
+static inline struct splay_rel_node *splay_rel_ptr(struct splay_rel *rel, uint64_t offset) {
+  return offset ? (struct splay_rel_node *) (rel->base + offset) : NULL;
+}
+
+static inline uint64_t splay_rel_offset(struct splay_rel *rel, const void *ptr) {
+  return ptr ? (uint64_t) ((const char *) ptr - rel->base) : 0;
+}
+
+int splay_rel_init(struct splay_rel *rel, void *base, size_t size);
+int splay_rel_attach(struct splay_rel *rel, void *base, size_t size);
+
+// 16-byte aligned object inside the region, NULL when it is full; there is no free
+void *splay_rel_alloc(struct splay_rel *rel, size_t size);
+
+// node must live in the region, the query nodes of the other calls may live anywhere
+void splay_rel_insert(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+void splay_rel_delete(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+
+struct splay_rel_node* splay_rel_search(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+struct splay_rel_node* splay_rel_search_lower(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+struct splay_rel_node* splay_rel_search_greater(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+struct splay_rel_node* splay_rel_find(struct splay_rel *rel, struct splay_rel_node *node, splay_rel_compare_func *func);
+struct splay_rel_node* splay_rel_first(struct splay_rel *rel);
+struct splay_rel_node* splay_rel_last(struct splay_rel *rel);
+struct splay_rel_node* splay_rel_prev(struct splay_rel *rel, struct splay_rel_node *node);
+struct splay_rel_node* splay_rel_next(struct splay_rel *rel, struct splay_rel_node *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
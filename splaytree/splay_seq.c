@@ -0,0 +1,189 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include "splay_seq.h"
+
+#define _seq(p)   _get_entry(p, struct splay_seq_node, node)
+
+INLINE size_t _size(struct splay_node *p) {
+  return p ? _seq(p)->size : 0;
+}
+
+INLINE void _fix(struct splay_node *p) {
+  _seq(p)->size = 1 + _size(p->left) + _size(p->right);
+}
+
+// top-down splay of the node at index (< size of the tree); the nodes put aside on the left
+// and right keep their final left (right) subtrees, so the sizes of both side trees are
+// known on the way down and handed out along their spines afterwards
+static struct splay_node *_splay_index(struct splay_node *root, size_t index) {
+  struct splay_node N, *left_t = &N, *right_t = &N, *y;
+  size_t left_size = 0, right_size = 0;
+  N.left = N.right = NULL;
+
+  for (;;) {
+    size_t ls = _size(root->left);
+    if (index < ls) {
+      y = root->left;
+      if (index < _size(y->left)) {
+        root->left = y->right;
+        y->right = root;
+        _fix(root);
+        root = y;
+      }
+      right_t->left = root;
+      right_t = root;
+      right_size += 1 + _size(root->right);
+      root = root->left;
+    } else if (index > ls) {
+      index -= ls + 1;
+      y = root->right;
+      if (index > _size(y->left)) {
+        index -= _size(y->left) + 1;
+        root->right = y->left;
+        y->left = root;
+        _fix(root);
+        root = y;
+      }
+      left_t->right = root;
+      left_t = root;
+      left_size += 1 + _size(root->left);
+      root = root->right;
+    } else {
+      break;
+    }
+  }
+
+  left_size += _size(root->left);
+  right_size += _size(root->right);
+  left_t->right = root->left;
+  right_t->left = root->right;
+
+  for(y = N.right; left_t != &N; y = y->right) {
+    _seq(y)->size = left_size;
+    left_size -= 1 + _size(y->left);
+    if (y == left_t) break;
+  }
+  for(y = N.left; right_t != &N; y = y->left) {
+    _seq(y)->size = right_size;
+    right_size -= 1 + _size(y->right);
+    if (y == right_t) break;
+  }
+
+  root->left = N.right;
+  root->right = N.left;
+  _fix(root);
+  return root;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+void splay_seq_init(struct splay_seq *seq) {
+  seq->root = NULL;
+}
+
+size_t splay_seq_size(struct splay_seq *seq) {
+  return _size(seq->root);
+}
+
+struct splay_seq_node* splay_seq_at(struct splay_seq *seq, size_t index) {
+  if (index >= _size(seq->root)) return NULL;
+  seq->root = _splay_index(seq->root, index);
+  return _seq(seq->root);
+}
+
+void splay_seq_insert(struct splay_seq *seq, size_t index, struct splay_seq_node *node) {
+  size_t size = _size(seq->root);
+  struct splay_node *p = &node->node;
+
+  if (index >= size) {
+    // append, after the last node splayed to the root
+    p->left = size ? _splay_index(seq->root, size - 1) : NULL;
+    p->right = NULL;
+  } else {
+    struct splay_node *root = _splay_index(seq->root, index);
+    p->left = root->left;
+    p->right = root;
+    root->left = NULL;
+    _fix(root);
+  }
+  _fix(p);
+  seq->root = p;
+}
+
+struct splay_seq_node* splay_seq_erase(struct splay_seq *seq, size_t index) {
+  if (index >= _size(seq->root)) return NULL;
+  struct splay_node *root = _splay_index(seq->root, index);
+
+  if (!root->left) {
+    seq->root = root->right;
+  } else {
+    // the last node of the left part comes up with no right child
+    seq->root = _splay_index(root->left, index - 1);
+    seq->root->right = root->right;
+    _fix(seq->root);
+  }
+  root->left = root->right = NULL;
+  _seq(root)->size = 1;
+  return _seq(root);
+}
+
+void splay_seq_split(struct splay_seq *seq, size_t index, struct splay_seq *right) {
+  size_t size = _size(seq->root);
+  if (index >= size) {
+    right->root = NULL;
+    return;
+  }
+
+  struct splay_node *root = _splay_index(seq->root, index);
+  seq->root = root->left;
+  root->left = NULL;
+  _fix(root);
+  right->root = root;
+}
+
+void splay_seq_concat(struct splay_seq *seq, struct splay_seq *right) {
+  size_t size = _size(seq->root);
+  if (!size) {
+    seq->root = right->root;
+  } else if (right->root) {
+    seq->root = _splay_index(seq->root, size - 1);
+    seq->root->right = right->root;
+    _fix(seq->root);
+  }
+  right->root = NULL;
+}
@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_SEQ
+#define _DUYNGUYEN_SPLAY_SEQ
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Sequence indexed by position (implicit keys)
+ *
+ * Nodes are ordered by where they were inserted rather than by a key, and every node counts
+ * the nodes of its subtree, so that the top-down splay can descend by index. Random access,
+ * insert and erase at a position, split and concat are all O(log n) amortized; walking the
+ * positions in order is O(1) amortized per step.
+ *
+ * Only the left / right links of the embedded splay_node are used.
+ */
+struct splay_seq_node {
+  struct splay_node node;
+  size_t size;
+};
+
+struct splay_seq {
+  struct splay_node *root;
+};
+
+void splay_seq_init(struct splay_seq *seq);
+size_t splay_seq_size(struct splay_seq *seq);
+
+// node at index, NULL past the end
+struct splay_seq_node* splay_seq_at(struct splay_seq *seq, size_t index);
+
+// node ends up at index (at most the size, which appends), what was there moves after it
+void splay_seq_insert(struct splay_seq *seq, size_t index, struct splay_seq_node *node);
+struct splay_seq_node* splay_seq_erase(struct splay_seq *seq, size_t index);
+
+// the nodes from index on move to the empty sequence right
+void splay_seq_split(struct splay_seq *seq, size_t index, struct splay_seq *right);
+// appends every node of right, which is left empty
+void splay_seq_concat(struct splay_seq *seq, struct splay_seq *right);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
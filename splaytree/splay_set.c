@@ -0,0 +1,261 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include "splay_set.h"
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+enum {
+  _SIMILAR,
+  _A_SMALL,
+  _B_SMALL,
+};
+
+/**
+ * @brief    Walks
+ *
+ * x and y are the next unread nodes of a and b. With order links splay_next() does not
+ * restructure, so a node can be relinked by splay_build() or moved to another tree as soon
+ * as the walk is past it. The nodes of b that a union leaves behind are chained through left.
+ */
+struct _set_walk {
+  struct splay_tree *a, *b;
+  struct splay_node *x, *y;
+  compare_func *func;
+  bool search;        // look nodes up in b instead of walking it
+  bool keep;          // a filter keeps the nodes found in b, or the ones not found
+  splay_set_func *drop;
+  void *arg;
+  struct splay_node *head, *tail;
+  size_t count;
+};
+
+INLINE void _walk_init(struct _set_walk *walk, struct splay_tree *a, struct splay_tree *b,
+                       compare_func *func, bool search) {
+  walk->a = a;
+  walk->b = b;
+  walk->x = splay_first(a);
+  walk->y = search ? NULL : splay_first(b);
+  walk->func = func;
+  walk->search = search;
+  walk->keep = true;
+  walk->drop = NULL;
+  walk->arg = NULL;
+  walk->head = walk->tail = NULL;
+  walk->count = 0;
+}
+
+INLINE struct splay_node *_next_a(struct _set_walk *walk) {
+  struct splay_node *node = walk->x;
+  walk->x = splay_next(walk->a, node, walk->func);
+  return node;
+}
+
+INLINE struct splay_node *_next_b(struct _set_walk *walk) {
+  struct splay_node *node = walk->y;
+  walk->y = splay_next(walk->b, node, walk->func);
+  return node;
+}
+
+// the node of b equal to node, asked in ascending order
+INLINE struct splay_node *_member(struct _set_walk *walk, struct splay_node *node) {
+  if (walk->search) return splay_search(walk->b, node, walk->func);
+  while (walk->y && walk->func(walk->y, node) < 0) _next_b(walk);
+  return (walk->y && walk->func(walk->y, node) == 0) ? walk->y : NULL;
+}
+
+INLINE void _leave(struct _set_walk *walk, struct splay_node *node) {
+  node->left = NULL;
+  if (walk->tail) walk->tail->left = node;
+  else walk->head = node;
+  walk->tail = node;
+}
+
+// source for splay_build(): a merged with b, b's node of an equal pair is left behind
+static struct splay_node *_union_next(void *arg) {
+  struct _set_walk *walk = (struct _set_walk *) arg;
+  int cmp;
+  if (!walk->x && !walk->y) return NULL;
+  cmp = !walk->y ? -1 : !walk->x ? 1 : walk->func(walk->x, walk->y);
+  if (cmp == 0) _leave(walk, _next_b(walk));
+  if (cmp <= 0) return _next_a(walk);
+  walk->count ++;
+  return _next_b(walk);
+}
+
+// source for splay_build(): the nodes of a that pass the filter
+static struct splay_node *_filter_next(void *arg) {
+  struct _set_walk *walk = (struct _set_walk *) arg;
+  struct splay_node *node;
+  while (walk->x) {
+    node = _next_a(walk);
+    if ((_member(walk, node) != NULL) == walk->keep) return node;
+    walk->count ++;
+    if (walk->drop) walk->drop(node, walk->arg);
+  }
+  return NULL;
+}
+
+static struct splay_node *_list_next(void *arg) {
+  struct _set_walk *walk = (struct _set_walk *) arg;
+  struct splay_node *node = walk->head;
+  if (node) walk->head = node->left;
+  return node;
+}
+
+// walk both in step; once one ends, go on with the other only until it is RATIO times longer
+static int _compare_sizes(struct splay_tree *a, struct splay_tree *b, compare_func *func) {
+  struct splay_node *x = splay_first(a), *y = splay_first(b), *cur;
+  struct splay_tree *tree;
+  size_t count = 0, limit;
+
+  while (x && y) {
+    x = splay_next(a, x, func);
+    y = splay_next(b, y, func);
+    count ++;
+  }
+  if (!x && !y) return _SIMILAR;
+
+  tree = x ? a : b;
+  cur = x ? x : y;
+  for(limit = count * (SPLAY_SET_RATIO - 1); cur && limit; limit --) {
+    cur = splay_next(tree, cur, func);
+  }
+  if (!cur) return _SIMILAR;
+  return x ? _B_SMALL : _A_SMALL;
+}
+
+// rebuilds a from its nodes that pass the filter
+static size_t _filter(struct splay_tree *a, struct splay_tree *b, compare_func *func, bool search,
+                      bool keep, splay_set_func *drop, void *arg) {
+  struct _set_walk walk;
+  _walk_init(&walk, a, b, func, search);
+  walk.keep = keep;
+  walk.drop = drop;
+  walk.arg = arg;
+  splay_build(a, _filter_next, &walk);
+  return walk.count;
+}
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+size_t splay_set_visit(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                       enum splay_set_op op, splay_set_func *visit, void *arg) {
+  struct _set_walk walk;
+  struct splay_node *node;
+  size_t count = 0;
+  int sizes = op == SPLAY_SET_UNION ? _SIMILAR : _compare_sizes(a, b, func);
+
+  if (op == SPLAY_SET_INTERSECTION && sizes == _B_SMALL) {
+    // the other way around, so that the lookups go to the bigger tree
+    _walk_init(&walk, b, a, func, true);
+    while (walk.x) {
+      if ((node = _member(&walk, _next_a(&walk)))) {
+        visit(node, arg);
+        count ++;
+      }
+    }
+    return count;
+  }
+
+  _walk_init(&walk, a, b, func, sizes == _A_SMALL);
+  while (walk.x || walk.y) {
+    if (op == SPLAY_SET_UNION) {
+      int cmp = !walk.y ? -1 : !walk.x ? 1 : func(walk.x, walk.y);
+      if (cmp == 0) _next_b(&walk);
+      visit(cmp <= 0 ? _next_a(&walk) : _next_b(&walk), arg);
+      count ++;
+      continue;
+    }
+    if (!walk.x) break;
+    node = _next_a(&walk);
+    if ((_member(&walk, node) != NULL) == (op == SPLAY_SET_INTERSECTION)) {
+      visit(node, arg);
+      count ++;
+    }
+  }
+  return count;
+}
+
+size_t splay_set_union(struct splay_tree *a, struct splay_tree *b, compare_func *func) {
+  struct _set_walk walk;
+  struct splay_node *node;
+
+  if (_compare_sizes(a, b, func) == _B_SMALL) {
+    _walk_init(&walk, b, a, func, true);
+    while (walk.x) {
+      node = _next_a(&walk);
+      if (splay_search(a, node, func)) {
+        _leave(&walk, node);
+      } else {
+        splay_insert(a, node, func);
+        walk.count ++;
+      }
+    }
+  } else {
+    _walk_init(&walk, a, b, func, false);
+    splay_build(a, _union_next, &walk);
+  }
+  splay_build(b, _list_next, &walk);
+  return walk.count;
+}
+
+size_t splay_set_intersect(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                           splay_set_func *drop, void *arg) {
+  return _filter(a, b, func, _compare_sizes(a, b, func) == _A_SMALL, true, drop, arg);
+}
+
+size_t splay_set_subtract(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                          splay_set_func *drop, void *arg) {
+  struct _set_walk walk;
+  struct splay_node *node;
+  int sizes = _compare_sizes(a, b, func);
+
+  if (sizes != _B_SMALL) return _filter(a, b, func, sizes == _A_SMALL, false, drop, arg);
+
+  _walk_init(&walk, b, a, func, true);
+  while (walk.x) {
+    if ((node = splay_search(a, _next_a(&walk), func))) {
+      splay_delete(a, node, func);
+      walk.count ++;
+      if (drop) drop(node, arg);
+    }
+  }
+  return walk.count;
+}
+
+#endif /* _SPLAY_SIBLING_POINTER || _SPLAY_THREADED */
@@ -0,0 +1,83 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_SET
+#define _DUYNGUYEN_SPLAY_SET
+
+#include "splaytree.h"
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Union, intersection and difference of two trees of unique nodes
+ *
+ * When the trees have similar sizes both are walked in order along their order links and
+ * merged in linear time; a destructive result is linked back balanced with splay_build().
+ * When one tree is more than SPLAY_SET_RATIO times smaller, its nodes are looked up in the
+ * other one in ascending order instead: consecutive splays start next to the previous one,
+ * so k lookups over n nodes cost about O(k log(n / k)). The sizes are found by walking
+ * both trees in step, which stops as soon as the ratio is passed.
+ *
+ * splay_set_visit() leaves the contents of both trees alone and reports the nodes of the
+ * result in order; of two equal nodes, the one from a. The other functions change a in
+ * place and return how many nodes they moved or removed.
+ */
+#ifndef SPLAY_SET_RATIO
+#define SPLAY_SET_RATIO 4
+#endif
+
+enum splay_set_op {
+  SPLAY_SET_UNION,
+  SPLAY_SET_INTERSECTION,
+  SPLAY_SET_DIFFERENCE,
+};
+
+typedef void splay_set_func (struct splay_node *node, void *arg);
+
+size_t splay_set_visit(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                       enum splay_set_op op, splay_set_func *visit, void *arg);
+
+// moves the nodes of b without an equal in a over to a, b keeps the others
+size_t splay_set_union(struct splay_tree *a, struct splay_tree *b, compare_func *func);
+// remove from a the nodes without (with) an equal in b, handing them to drop (may be NULL)
+size_t splay_set_intersect(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                           splay_set_func *drop, void *arg);
+size_t splay_set_subtract(struct splay_tree *a, struct splay_tree *b, compare_func *func,
+                          splay_set_func *drop, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SPLAY_SIBLING_POINTER || _SPLAY_THREADED */
+
+#endif
@@ -0,0 +1,170 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "splay_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define _SPLAY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+typedef uint32_t lower_bound_u32_func (const uint32_t *keys, uint32_t count, uint32_t key);
+typedef uint32_t lower_bound_u64_func (const uint64_t *keys, uint32_t count, uint64_t key);
+
+static uint32_t _lower_bound_u32_scalar(const uint32_t *keys, uint32_t count, uint32_t key) {
+  uint32_t idx, below = 0;
+  for(idx = 0; idx < count; idx ++) {
+    below += keys[idx] < key;
+  }
+  return below;
+}
+
+static uint32_t _lower_bound_u64_scalar(const uint64_t *keys, uint32_t count, uint64_t key) {
+  uint32_t idx, below = 0;
+  for(idx = 0; idx < count; idx ++) {
+    below += keys[idx] < key;
+  }
+  return below;
+}
+
+#ifdef _SPLAY_SIMD_X86
+
+// x86 only has signed integer compares, flipping the sign bit turns them into unsigned ones
+
+__attribute__((target("sse4.2")))
+static uint32_t _lower_bound_u32_sse42(const uint32_t *keys, uint32_t count, uint32_t key) {
+  const __m128i sign = _mm_set1_epi32((int) 0x80000000);
+  const __m128i needle = _mm_xor_si128(_mm_set1_epi32((int) key), sign);
+  uint32_t idx = 0, below = 0;
+  for(; idx + 4 <= count; idx += 4) {
+    __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (keys + idx)), sign);
+    below += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, v))));
+  }
+  return below + _lower_bound_u32_scalar(keys + idx, count - idx, key);
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t _lower_bound_u64_sse42(const uint64_t *keys, uint32_t count, uint64_t key) {
+  const __m128i sign = _mm_set1_epi64x((long long) 0x8000000000000000ULL);
+  const __m128i needle = _mm_xor_si128(_mm_set1_epi64x((long long) key), sign);
+  uint32_t idx = 0, below = 0;
+  for(; idx + 2 <= count; idx += 2) {
+    __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (keys + idx)), sign);
+    below += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(needle, v))));
+  }
+  return below + _lower_bound_u64_scalar(keys + idx, count - idx, key);
+}
+
+__attribute__((target("avx2")))
+static uint32_t _lower_bound_u32_avx2(const uint32_t *keys, uint32_t count, uint32_t key) {
+  const __m256i sign = _mm256_set1_epi32((int) 0x80000000);
+  const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32((int) key), sign);
+  uint32_t idx = 0, below = 0;
+  for(; idx + 8 <= count; idx += 8) {
+    __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (keys + idx)), sign);
+    below += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, v))));
+  }
+  return below + _lower_bound_u32_scalar(keys + idx, count - idx, key);
+}
+
+__attribute__((target("avx2")))
+static uint32_t _lower_bound_u64_avx2(const uint64_t *keys, uint32_t count, uint64_t key) {
+  const __m256i sign = _mm256_set1_epi64x((long long) 0x8000000000000000ULL);
+  const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x((long long) key), sign);
+  uint32_t idx = 0, below = 0;
+  for(; idx + 4 <= count; idx += 4) {
+    __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (keys + idx)), sign);
+    below += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, v))));
+  }
+  return below + _lower_bound_u64_scalar(keys + idx, count - idx, key);
+}
+
+#endif /* _SPLAY_SIMD_X86 */
+
+static uint32_t _lower_bound_u32_resolve(const uint32_t *keys, uint32_t count, uint32_t key);
+static uint32_t _lower_bound_u64_resolve(const uint64_t *keys, uint32_t count, uint64_t key);
+
+static lower_bound_u32_func *_lower_bound_u32 = _lower_bound_u32_resolve;
+static lower_bound_u64_func *_lower_bound_u64 = _lower_bound_u64_resolve;
+
+// other threads may be searching while the kernels are swapped, every kernel is correct
+// so a relaxed atomic access is all it takes to keep the pointers whole
+#define _load_kernel(fn)        __atomic_load_n(&(fn), __ATOMIC_RELAXED)
+#define _store_kernel(fn, impl) __atomic_store_n(&(fn), &(impl), __ATOMIC_RELAXED)
+
+enum splay_simd_level splay_simd_detect(void) {
+#ifdef _SPLAY_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return SPLAY_SIMD_AVX2;
+  if (__builtin_cpu_supports("sse4.2")) return SPLAY_SIMD_SSE42;
+#endif
+  return SPLAY_SIMD_SCALAR;
+}
+
+enum splay_simd_level splay_simd_select(enum splay_simd_level level) {
+  enum splay_simd_level supported = splay_simd_detect();
+  if (level > supported) level = supported;
+
+  switch (level) {
+#ifdef _SPLAY_SIMD_X86
+    case SPLAY_SIMD_AVX2:
+      _store_kernel(_lower_bound_u32, _lower_bound_u32_avx2);
+      _store_kernel(_lower_bound_u64, _lower_bound_u64_avx2);
+      break;
+    case SPLAY_SIMD_SSE42:
+      _store_kernel(_lower_bound_u32, _lower_bound_u32_sse42);
+      _store_kernel(_lower_bound_u64, _lower_bound_u64_sse42);
+      break;
+#endif
+    default:
+      _store_kernel(_lower_bound_u32, _lower_bound_u32_scalar);
+      _store_kernel(_lower_bound_u64, _lower_bound_u64_scalar);
+      level = SPLAY_SIMD_SCALAR;
+      break;
+  }
+  return level;
+}
+
+// first call picks the kernels, racing threads all store the same pointers
+static uint32_t _lower_bound_u32_resolve(const uint32_t *keys, uint32_t count, uint32_t key) {
+  splay_simd_select(SPLAY_SIMD_AVX2);
+  return _load_kernel(_lower_bound_u32)(keys, count, key);
+}
+
+static uint32_t _lower_bound_u64_resolve(const uint64_t *keys, uint32_t count, uint64_t key) {
+  splay_simd_select(SPLAY_SIMD_AVX2);
+  return _load_kernel(_lower_bound_u64)(keys, count, key);
+}
+
+uint32_t splay_lower_bound_u32(const uint32_t *keys, uint32_t count, uint32_t key) {
+  return _load_kernel(_lower_bound_u32)(keys, count, key);
+}
+
+uint32_t splay_lower_bound_u64(const uint64_t *keys, uint32_t count, uint64_t key) {
+  return _load_kernel(_lower_bound_u64)(keys, count, key);
+}
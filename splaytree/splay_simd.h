@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_SIMD
+#define _DUYNGUYEN_SPLAY_SIMD
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Vectorized lower bound over a small sorted array of integer keys
+ *
+ * Returns the index of the first key >= key (count if there is none) by counting the keys
+ * below it, so the kernel has no data-dependent branch. It scans the whole array and is
+ * meant for blocks of a few cache lines. The AVX2, SSE4.2 or scalar version is picked on
+ * the first call from CPUID.
+ */
+enum splay_simd_level {
+  SPLAY_SIMD_SCALAR = 0,
+  SPLAY_SIMD_SSE42  = 1,
+  SPLAY_SIMD_AVX2   = 2,
+};
+
+uint32_t splay_lower_bound_u32(const uint32_t *keys, uint32_t count, uint32_t key);
+uint32_t splay_lower_bound_u64(const uint64_t *keys, uint32_t count, uint64_t key);
+
+enum splay_simd_level splay_simd_detect(void);
+// pin the kernels to a level (capped at what the CPU supports), returns the level in use
+enum splay_simd_level splay_simd_select(enum splay_simd_level level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
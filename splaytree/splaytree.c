@@ -38,303 +38,770 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include "splaytree.h"
 
-INLINE struct splay_node *_right_rotate(struct splay_node *x) {
-  struct splay_node *y = x->left;
-  x->left = y->right;
-  y->right = x;
-  return y;
+// with these as compare_func, a splay brings up the minimum (maximum) of the tree
+static int _after_query(struct splay_node *a, struct splay_node *b) {
+  return 1;
 }
 
-INLINE struct splay_node *_left_rotate(struct splay_node *x) {
-  struct splay_node *y = x->right;
-  x->right = y->left;
-  y->left = x;
-  return y;
+#ifdef _SPLAY_AUGMENT
+static int _before_query(struct splay_node *a, struct splay_node *b) {
+  return -1;
 }
-
-INLINE void _init_splay_node(struct splay_node* p) {
-  p->left = p->right = NULL;
-#ifdef _SPLAY_SIBLING_POINTER
-  p->prev = p->next = NULL;
 #endif
+
+// the generic instance of the template, every comparison goes through func
+#define _SPLAY_NODE             struct splay_node
+#define _SPLAY_TREE             struct splay_tree
+#define _SPLAY_FUNC             compare_func
+#define _SPLAY_CMP(node, query) func(node, query)
+#include "splaytree.inc"
+
+// flatten the tree into a right-linked vine in O(n) rotations, returns the number of nodes
+INLINE size_t _tree_to_vine(struct splay_node **root) {
+  struct splay_node N, *tail = &N, *rest = *root;
+  size_t count = 0;
+  N.right = rest;
+  while (rest && !_is_thread(rest)) {
+    if (!_is_thread(rest->left)) {
+      rest = _right_rotate(rest);
+      tail->right = rest;
+    } else {
+      tail = rest;
+      rest = rest->right;
+      count ++;
+    }
+  }
+  *root = N.right;
+  return count;
+}
+
+// left rotations on every other node of the top of the vine
+INLINE void _vine_compress(struct splay_node *scanner, size_t count) {
+  while (count --) {
+    scanner->right = _left_rotate(scanner->right);
+    scanner = scanner->right;
+  }
 }
 
-struct splay_node *_splay(struct splay_node *root,
-                          struct splay_node *query,
-                          compare_func *func,
-                          int *cmpRet) {
-  if (!root) return root;
+// Day-Stout-Warren: fold a right-linked vine of count nodes into a balanced tree in O(n)
+INLINE void _vine_to_tree(struct splay_node **root, size_t count) {
   struct splay_node N;
-  N.left = N.right = NULL;
-  struct splay_node *left_t, *right_t;
-  left_t = right_t = &N;
+  size_t full = 1;
+  N.right = *root;
+  while (full <= count + 1) full <<= 1;
+  full = (full >> 1) - 1;
+  // first the nodes below the last complete level, then halve the spine level by level
+  _vine_compress(&N, count - full);
+  for(count = full; count > 1; ) {
+    count >>= 1;
+    _vine_compress(&N, count);
+  }
+  *root = N.right;
+}
 
-  for (;;) {
-    *cmpRet = func(root, query);
-    if (*cmpRet == 0) break;
+#ifdef _SPLAY_AUGMENT
+// children first, for trees linked without going through the hook
+static void _update_all(struct splay_node *root, splay_update_func *update) {
+  if (!update || !root || _is_thread(root)) return;
+  _update_all(root->left, update);
+  _update_all(root->right, update);
+  update(root);
+}
+#endif
 
-    if (*cmpRet > 0) {
-      if (!root->left) break;
+#ifdef _SPLAY_SMALL_TREE
 
-      if (func(root->left, query) > 0) {
-        root = _right_rotate(root);
-        if (!root->left) break;
-      }
-      right_t->left = root;
-      right_t = root;
-      root = root->left;
-    } else {
-      if (!root->right) break;
+/**
+ * @brief    Small tree mode
+ *
+ * While tree->root is NULL, the (at most _SPLAY_SMALL_SIZE) nodes live in tree->small, sorted,
+ * and every operation is a linear scan. Filling the array up promotes it to a balanced tree,
+ * a tree that shrinks to half of it is demoted back. The sibling chain is kept in both modes.
+ */
 
-      if (func(root->right, query) < 0) {
-        root = _left_rotate(root);
-        if(!root->right) break;
-      }
+// index of the first node >= query, *cmpRet is its comparison (1 if there is none)
+INLINE size_t _small_lower_bound(struct splay_tree *tree, struct splay_node *node,
+                                 compare_func *func, int *cmpRet) {
+  size_t pos;
+  *cmpRet = 1;
+  for(pos = 0; pos < tree->count; pos ++) {
+    *cmpRet = func(tree->small[pos], node);
+    if (*cmpRet >= 0) break;
+  }
+  if (pos == tree->count) *cmpRet = 1;
+  return pos;
+}
+
+// prev and next are the neighbours of the range, for the threads at its ends
+static struct splay_node *_build_balanced(struct splay_node **nodes, size_t count,
+                                          struct splay_node *prev, struct splay_node *next
+                                          _UPDATE_PARAM) {
+  size_t mid = count / 2;
+  struct splay_node *root = nodes[mid];
+  root->left = mid ? _build_balanced(nodes, mid, prev, root _UPDATE_PASS) : _thread(prev);
+  root->right = (mid + 1 < count) ? _build_balanced(nodes + mid + 1, count - mid - 1, root, next _UPDATE_PASS) : _thread(next);
+  _update(root);
+  return root;
+}
+
+INLINE void _small_promote(struct splay_tree *tree) {
+  tree->root = tree->count ? _build_balanced(tree->small, tree->count, NULL, NULL _UPDATE_OF(tree)) : NULL;
+}
+
+INLINE void _small_demote(struct splay_tree *tree) {
+  struct splay_node *cur;
+  size_t count = 0;
+  _tree_to_vine(&tree->root);
+  for(cur = tree->root; cur && !_is_thread(cur); cur = cur->right) {
+    tree->small[count ++] = cur;
+  }
+  tree->root = NULL;
+}
+
+// false when the array is full and the node has to go to a real tree,
+// with multi an equal node goes after the ones already there
+static bool _small_insert(struct splay_tree *tree, struct splay_node *node, compare_func *func, bool multi) {
+  int cmp;
+  size_t pos = _small_lower_bound(tree, node, func, &cmp), idx;
+  if (cmp == 0 && !multi) return true;
+  if (tree->count == _SPLAY_SMALL_SIZE) return false;
+  while (pos < tree->count && func(tree->small[pos], node) == 0) pos ++;
 
-      left_t->right = root;
-			left_t = root;
-			root = root->right;
+  _init_splay_node(node);
+  for(idx = tree->count; idx > pos; idx --) {
+    tree->small[idx] = tree->small[idx - 1];
+  }
+  tree->small[pos] = node;
+  tree->count ++;
+
+#ifdef _SPLAY_SIBLING_POINTER
+  node->prev = pos ? tree->small[pos - 1] : NULL;
+  node->next = (pos + 1 < tree->count) ? tree->small[pos + 1] : NULL;
+  if (node->prev) node->prev->next = node;
+  if (node->next) node->next->prev = node;
+#endif
+#ifdef _SPLAY_XOR_SIBLING
+  _xor_splice(pos ? tree->small[pos - 1] : NULL, node,
+              (pos + 1 < tree->count) ? tree->small[pos + 1] : NULL);
+#endif
+  return true;
+}
+
+// position of the node itself (or of the first equal one), count if it is not in the array
+INLINE size_t _small_position(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+  int cmp;
+  size_t pos = _small_lower_bound(tree, node, func, &cmp), idx;
+  if (cmp != 0) return tree->count;
+  for(idx = pos; idx < tree->count && tree->small[idx] != node; idx ++) {
+    if (func(tree->small[idx], node) != 0) return pos;
+  }
+  return idx < tree->count ? idx : pos;
+}
+
+// with exact, node itself if it is in the array, otherwise the first equal one
+static bool _small_delete(struct splay_tree *tree, struct splay_node *node, compare_func *func, bool exact) {
+  int cmp;
+  size_t pos = _small_lower_bound(tree, node, func, &cmp), idx;
+  if (cmp != 0) return false;
+  for(idx = pos; exact && idx < tree->count && func(tree->small[idx], node) == 0; idx ++) {
+    if (tree->small[idx] == node) {
+      pos = idx;
+      break;
     }
   }
+#ifdef _SPLAY_SIBLING_POINTER
+  struct splay_node *cur = tree->small[pos];
+  if (cur->prev) cur->prev->next = cur->next;
+  if (cur->next) cur->next->prev = cur->prev;
+  cur->prev = cur->next = NULL;
+#endif
+#ifdef _SPLAY_XOR_SIBLING
+  _xor_unsplice(pos ? tree->small[pos - 1] : NULL, tree->small[pos],
+                (pos + 1 < tree->count) ? tree->small[pos + 1] : NULL);
+#endif
 
-  left_t->right = root->left;
-  right_t->left = root->right;
-  root->left = N.right;
-  root->right = N.left;
-  return root;
+  tree->count --;
+  for(idx = pos; idx < tree->count; idx ++) {
+    tree->small[idx] = tree->small[idx + 1];
+  }
+  return true;
 }
 
+#endif /* _SPLAY_SMALL_TREE */
+
 /**
  * @brief    Below is the implementation of all public functions
  */
 void splay_tree_init(struct splay_tree *tree) {
   tree->root = NULL;
+#ifdef _SPLAY_SMALL_TREE
+  tree->count = 0;
+#endif
+#ifdef _SPLAY_AUGMENT
+  tree->update = NULL;
+#endif
 }
 
-
-#ifndef _SPLAY_INSERT_RANDOM
+#ifdef _SPLAY_AUGMENT
+void splay_tree_init_augmented(struct splay_tree *tree, splay_update_func *update) {
+  splay_tree_init(tree);
+  tree->update = update;
+}
+#endif
 
 void splay_insert(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  _init_splay_node(node);
-
+#ifdef _SPLAY_SMALL_TREE
   if (!tree->root) {
-    tree->root = node;
-    return;
+    if (_small_insert(tree, node, func, false)) return;
+    _small_promote(tree);
   }
-
-  int cmp = 0;
-  tree->root = _splay(tree->root, node, func, &cmp);
-  if (cmp == 0) return;
-  if (cmp > 0) {
-    node->right       = tree->root;
-    node->left        = tree->root->left;
-    tree->root->left  = NULL;
-#ifdef _SPLAY_SIBLING_POINTER
-    node->next        = tree->root;
-    node->prev        = tree->root->prev;
-    if (tree->root->prev) {
-      tree->root->prev->next = node;
-    }
-    tree->root->prev  = node;
+  if (_tree_insert(tree, node, func)) tree->count ++;
+#else
+  _tree_insert(tree, node, func);
 #endif
-  } else {
-    node->left        = tree->root;
-    node->right       = tree->root->right;
-    tree->root->right = NULL;
-#ifdef _SPLAY_SIBLING_POINTER
-    node->prev        = tree->root;
-    node->next        = tree->root->next;
-    if (tree->root->next) {
-      tree->root->next->prev = node;
-    }
-    tree->root->next  = node;
+}
+
+static bool _delete(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) return _small_delete(tree, node, func, false);
+  if (!_tree_delete(tree, node, func)) return false;
+  if (-- tree->count <= _SPLAY_SMALL_SIZE / 2) _small_demote(tree);
+  return true;
+#else
+  return _tree_delete(tree, node, func);
 #endif
-  }
-  tree->root = node;
 }
 
-#else /* _SPLAY_INSERT_RANDOM */
+void splay_delete(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+  _delete(tree, node, func);
+}
 
-void splay_insert(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  _init_splay_node(node);
+size_t splay_delete_all(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+  size_t count = 0;
+  while (_delete(tree, node, func)) count ++;
+  return count;
+}
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+/**
+ * @brief    Multiset
+ *
+ * splay_insert_multi links a node even if equal ones are there, after all of them, so the in-order
+ * walk keeps duplicates in insertion order. It always splays the new node to the root.
+ * splay_delete_multi removes the node passed in rather than whichever equal node the splay reaches;
+ * splay_delete stays as cheap as in a set.
+ */
 
+void splay_insert_multi(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    if (_small_insert(tree, node, func, true)) return;
+    _small_promote(tree);
+  }
+  tree->count ++;
+#endif
+  _init_splay_node(node);
   if (!tree->root) {
+    _tree_update(tree, node);
     tree->root = node;
     return;
   }
 
+  int cmp = 0;
+  tree->root = _splay_bias(tree->root, node, func, -1, &cmp _UPDATE_OF(tree));
+  _link_root(tree, node, cmp);
+}
+
+// with the root equal to node, bring up node itself if it is linked among the equal nodes of a
+// multiset, otherwise the first of them
+static void _splay_exact(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+  struct splay_node *pred = _pred(tree->root), *succ = _succ(tree->root), *target, *cur;
   int cmp;
-  struct splay_node *cur = tree->root;
-  struct splay_node *p = NULL;
+  if ((!pred || func(pred, node) != 0) && (!succ || func(succ, node) != 0)) return;
+
+  tree->root = _splay_bias(tree->root, node, func, 1, &cmp _UPDATE_OF(tree));
+  target = cmp > 0 ? tree->root : _succ(tree->root);
+  for(cur = target; cur && cur != node && func(cur, node) == 0; cur = _succ(cur));
+  if (cur == node) target = node;
+
+  // step the root along the run: the successor is the minimum of the right subtree,
+  // one left rotation after it is splayed up there
+  while (tree->root != target) {
+    cur = tree->root;
+    cur->right = _splay(cur->right, NULL, _after_query, &cmp _UPDATE_OF(tree));
+    tree->root = _left_rotate(cur);
+    _tree_update(tree, cur);
+    _tree_update(tree, tree->root);
+  }
+}
 
-  while(cur) {
-    cmp = func(cur, node);
-    if (cmp == 0) return;
 
-    p = cur;
-    cur = (cmp > 0) ? cur->left : cur->right;
+void splay_delete_multi(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    _small_delete(tree, node, func, true);
+    return;
   }
+#endif
+  if (!tree->root) return;
 
-  assert(p != NULL);
-  if(func(p, node) > 0) {
-    p->left = node;
-#ifdef _SPLAY_SIBLING_POINTER
-    node->next = p;
-    node->prev = p->prev;
-    if (p->prev) p->prev->next = node;
-    p->prev = node;
+  int cmp = 0;
+  tree->root = _splay(tree->root, node, func, &cmp _UPDATE_OF(tree));
+  if (cmp != 0) return;
+  if (tree->root != node) _splay_exact(tree, node, func);
+  _unlink_root(tree);
+#ifdef _SPLAY_SMALL_TREE
+  if (-- tree->count <= _SPLAY_SMALL_SIZE / 2) _small_demote(tree);
 #endif
-  } else {
-    p->right = node;
-#ifdef _SPLAY_SIBLING_POINTER
-    node->prev = p;
-    node->next = p->next;
-    if (p->next) p->next->prev = node;
-    p->next = node;
+}
+
+struct splay_node* splay_equal_range(struct splay_tree *tree, struct splay_node *node,
+                                     compare_func *func, struct splay_node **end) {
+  struct splay_node *first = NULL, *last = NULL;
+  int cmp = 0;
+
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    size_t pos = _small_lower_bound(tree, node, func, &cmp);
+    if (pos < tree->count) first = tree->small[pos];
+    while (pos < tree->count && func(tree->small[pos], node) == 0) pos ++;
+    if (pos < tree->count) last = tree->small[pos];
+  } else
 #endif
+  if (tree->root) {
+    // two biased splays, so that long runs of duplicates are never walked
+    tree->root = _splay_bias(tree->root, node, func, 1, &cmp _UPDATE_OF(tree));
+    first = cmp > 0 ? tree->root : _succ(tree->root);
+    tree->root = _splay_bias(tree->root, node, func, -1, &cmp _UPDATE_OF(tree));
+    last = cmp > 0 ? tree->root : _succ(tree->root);
   }
 
-  if (_SPLAY_RATIO) {
-    tree->root = _splay(tree->root, node, func, &cmp);
+  if (end) *end = last;
+  return first != last ? first : NULL;
+}
+
+size_t splay_count_equal(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+  struct splay_node *cur, *end;
+  size_t count = 0;
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    int cmp;
+    size_t pos = _small_lower_bound(tree, node, func, &cmp);
+    while (pos + count < tree->count && func(tree->small[pos + count], node) == 0) count ++;
+    return count;
+  }
+#endif
+  for(cur = splay_equal_range(tree, node, func, &end); cur && cur != end; cur = _succ(cur)) {
+    count ++;
   }
+  return count;
 }
 
-#endif /* _SPLAY_INSERT_RANDOM */
+#endif /* _SPLAY_SIBLING_POINTER || _SPLAY_THREADED */
 
-void splay_delete(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  if (!tree->root) return;
+struct splay_node* splay_search(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    size_t pos = _small_position(tree, node, func);
+    return pos < tree->count ? tree->small[pos] : NULL;
+  }
+#endif
+  return _tree_search(tree, node, func);
+}
 
-  int cmp = 0;
-  tree->root = _splay(tree->root, node, func, &cmp);
-  if (cmp != 0) return;
+struct splay_node* splay_search_lower(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    int cmp;
+    size_t pos = _small_lower_bound(tree, node, func, &cmp);
+    if (cmp == 0) return tree->small[pos];
+    return pos ? tree->small[pos - 1] : NULL;
+  }
+#endif
+  return _tree_search_lower(tree, node, func);
+}
 
-  if (!tree->root->left) {
-#ifdef _SPLAY_SIBLING_POINTER
-    if (tree->root->next)
-      tree->root->next->prev = NULL;
-    tree->root->next = NULL;
+struct splay_node* splay_search_greater(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    int cmp;
+    size_t pos = _small_lower_bound(tree, node, func, &cmp);
+    return pos < tree->count ? tree->small[pos] : NULL;
+  }
 #endif
-    tree->root = tree->root->right;
-  } else {
-    struct splay_node **root = &tree->root;
-    // splay the biggest node of the left subtree to the top, and then attach current right-subtree to that node
-    struct splay_node *pp = NULL, *p;
-    for (p = (*root)->left; p->right; p = p->right) {
-      pp = p;
-    }
-    if (pp) {
-      pp->right = p->left;
-      p->left = (*root)->left;
-      (*root)->left = p;
+  return _tree_search_greater(tree, node, func);
+}
+
+struct splay_node* splay_first(struct splay_tree *tree) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) return tree->count ? tree->small[0] : NULL;
+#endif
+  return _tree_first(tree);
+}
+
+struct splay_node* splay_last(struct splay_tree *tree) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) return tree->count ? tree->small[tree->count - 1] : NULL;
+#endif
+  return _tree_last(tree);
+}
+
+struct splay_node* splay_pop_first(struct splay_tree *tree) {
+  struct splay_node *root;
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    size_t idx;
+    if (!tree->count) return NULL;
+    root = tree->small[0];
+    tree->count --;
+    for(idx = 0; idx < tree->count; idx ++) {
+      tree->small[idx] = tree->small[idx + 1];
     }
+#ifdef _SPLAY_SIBLING_POINTER
+    if (root->next) root->next->prev = NULL;
+    root->next = NULL;
+#endif
+#ifdef _SPLAY_XOR_SIBLING
+    _xor_unsplice(NULL, root, tree->count ? tree->small[0] : NULL);
+#endif
+    return root;
+  }
+#endif
+  if (!tree->root) return NULL;
+
+  // the splay only follows left children, so it never calls a comparator
+  int notUsed;
+  root = tree->root = _splay(tree->root, NULL, _after_query, &notUsed _UPDATE_OF(tree));
 
-    p->right = (*root)->right;
+#ifdef _SPLAY_XOR_SIBLING
+  _xor_unsplice(NULL, root, _root_succ(root));
+#endif
 #ifdef _SPLAY_SIBLING_POINTER
-    p->next = (*root)->next;
-    if ((*root)->next) {
-      (*root)->next->prev = p;
-    }
+  if (root->next) root->next->prev = NULL;
+  root->next = NULL;
 #endif
-    *root = p;
+#ifdef _SPLAY_THREADED
+  if (!_is_thread(root->right)) {
+    _leftmost(root->right)->left = _thread(NULL);
   }
+#endif
+  tree->root = _is_thread(root->right) ? NULL : root->right;
+  root->left = root->right = _thread(NULL);
+#ifdef _SPLAY_SMALL_TREE
+  if (-- tree->count <= _SPLAY_SMALL_SIZE / 2) _small_demote(tree);
+#endif
+  return root;
 }
 
-struct splay_node* splay_search(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  int cmp = 0;
-  tree->root = _splay(tree->root, node, func, &cmp);
-  if (cmp == 0) {
-    return tree->root;
+struct splay_node* splay_prev(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#if defined(_SPLAY_SMALL_TREE) && !defined(_SPLAY_SIBLING_POINTER)
+  if (node && !tree->root) {
+    size_t pos = _small_position(tree, node, func);
+    return (pos < tree->count && pos) ? tree->small[pos - 1] : NULL;
   }
-
-  return NULL;
+#endif
+  return _tree_prev(tree, node, func);
 }
 
-struct splay_node* splay_search_lower(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  int cmp = 0;
-  tree->root = _splay(tree->root, node, func, &cmp);
-  if (cmp <= 0) {
-    return tree->root;
+struct splay_node* splay_next(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
+#if defined(_SPLAY_SMALL_TREE) && !defined(_SPLAY_SIBLING_POINTER)
+  if (node && !tree->root) {
+    size_t pos = _small_position(tree, node, func);
+    return (pos + 1 < tree->count) ? tree->small[pos + 1] : NULL;
   }
+#endif
+  return _tree_next(tree, node, func);
+}
 
-#ifdef _SPLAY_SIBLING_POINTER
-  return tree->root->prev;
+#ifdef _SPLAY_XOR_SIBLING
+
+/**
+ * @brief    Cursors over the xor-linked order
+ *
+ * A node only stores prev ^ next, so walking needs the node it came from. A cursor is started
+ * on the root or one of its neighbours, whose other neighbour can be found in the tree.
+ */
+
+// the node found by a search, which is the root or one of its neighbours
+static void _cursor_at(struct splay_tree *tree, struct splay_node *node,
+                       compare_func *func, struct splay_cursor *cursor) {
+  struct splay_node *root = tree->root, *pred;
+  cursor->node = node;
+  cursor->prev = NULL;
+  if (!node) return;
+
+#ifdef _SPLAY_SMALL_TREE
+  if (!root) {
+    size_t pos = _small_position(tree, node, func);
+    cursor->prev = pos ? tree->small[pos - 1] : NULL;
+    return;
+  }
 #endif
 
-  return splay_prev(tree, tree->root, func);
+  pred = _root_pred(root);
+  if (node == root) {
+    cursor->prev = pred;
+  } else if (node == pred) {
+    cursor->prev = _xor_sibling(node, root);
+  } else {
+    cursor->prev = root;
+  }
 }
 
-struct splay_node* splay_search_greater(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  int cmp = 0;
-  tree->root = _splay(tree->root, node, func, &cmp);
-  if (cmp >= 0) {
-    return tree->root;
-  }
+void splay_cursor_first(struct splay_tree *tree, struct splay_cursor *cursor) {
+  cursor->prev = NULL;
+  cursor->node = splay_first(tree);
+}
 
-#ifdef _SPLAY_SIBLING_POINTER
-  return tree->root->next;
-#endif
+void splay_cursor_last(struct splay_tree *tree, struct splay_cursor *cursor) {
+  cursor->node = splay_last(tree);
+  cursor->prev = cursor->node ? _xor_sibling(cursor->node, NULL) : NULL;
+}
 
-  return splay_next(tree, tree->root, func);
+void splay_cursor_lower(struct splay_tree *tree, struct splay_node *node,
+                        compare_func *func, struct splay_cursor *cursor) {
+  _cursor_at(tree, splay_search_lower(tree, node, func), func, cursor);
 }
 
-struct splay_node* splay_first(struct splay_tree *tree) {
-  if (!tree->root) return NULL;
-  struct splay_node *p, *pp = NULL;
-  for(p = tree->root; p->left; p = p->left) {
-    pp = p;
+void splay_cursor_greater(struct splay_tree *tree, struct splay_node *node,
+                          compare_func *func, struct splay_cursor *cursor) {
+  struct splay_node *cur = splay_search_greater(tree, node, func);
+  if (cur) {
+    _cursor_at(tree, cur, func, cursor);
+  } else {
+    // past the end, so that splay_cursor_prev steps onto the last node
+    splay_cursor_last(tree, cursor);
+    cursor->prev = cursor->node;
+    cursor->node = NULL;
   }
-  if (pp) {
-    pp->left = p->right;
-    p->right = tree->root;
-    tree->root = p;
+}
+
+void splay_cursor_next(struct splay_cursor *cursor) {
+  struct splay_node *next;
+  if (!cursor->node) return;
+  next = _xor_sibling(cursor->node, cursor->prev);
+  cursor->prev = cursor->node;
+  cursor->node = next;
+}
+
+void splay_cursor_prev(struct splay_cursor *cursor) {
+  struct splay_node *prev = cursor->prev;
+  if (!prev) {
+    cursor->node = NULL;
+    return;
   }
-  return p;
+  cursor->prev = _xor_sibling(prev, cursor->node);
+  cursor->node = prev;
 }
 
-struct splay_node* splay_last(struct splay_tree *tree) {
-  if (!tree->root) return NULL;
-  struct splay_node *p, *pp = NULL;
-  for(p = tree->root; p->right; p = p->right) {
-    pp = p;
+#endif /* _SPLAY_XOR_SIBLING */
+
+#ifdef _SPLAY_AUGMENT
+
+/**
+ * @brief    Range aggregate
+ *
+ * Splaying the last node <= hi (or the first one > hi) to the root and then the first node
+ * >= lo (or the last one < lo) to the top of its left subtree leaves [lo, hi] as at most one
+ * node, one whole subtree and the root, which is what visit gets.
+ */
+void splay_range_aggregate(struct splay_tree *tree, struct splay_node *lo, struct splay_node *hi,
+                           compare_func *func, splay_aggregate_func *visit, void *arg) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) {
+    size_t pos;
+    for(pos = 0; pos < tree->count; pos ++) {
+      if (func(tree->small[pos], lo) >= 0 && func(tree->small[pos], hi) <= 0) {
+        visit(tree->small[pos], false, arg);
+      }
+    }
+    return;
   }
-  if (pp) {
-    pp->right = p->left;
-    p->left = tree->root;
-    tree->root = p;
+#endif
+  if (!tree->root) return;
+
+  int cmp = 0;
+  tree->root = _splay_bias(tree->root, hi, func, -1, &cmp _UPDATE_OF(tree));
+  struct splay_node *root = tree->root, *sub;
+  // below hi, everything in range is in the left subtree
+  bool root_in = cmp < 0 && func(root, lo) >= 0;
+  if ((root_in || cmp > 0) && !_is_thread(root->left)) {
+    root->left = _splay_bias(root->left, lo, func, 1, &cmp _UPDATE_OF(tree));
+    sub = root->left;
+    if (cmp > 0) visit(sub, false, arg);
+    if (!_is_thread(sub->right)) visit(sub->right, true, arg);
   }
-  return p;
+  if (root_in) visit(root, false, arg);
 }
 
-struct splay_node* splay_prev(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  if (!node || !tree->root) return NULL;
+#endif /* _SPLAY_AUGMENT */
 
+/**
+ * @brief    Bulk build
+ *
+ * Nodes coming in ascending order are appended to a vine with their order links, then the
+ * vine is folded into a balanced tree. Linear in the number of nodes, no comparison is made.
+ */
+size_t splay_build(struct splay_tree *tree, splay_source_func *source, void *arg) {
+  struct splay_node N, *tail = &N, *node;
+  size_t count = 0;
+  N.right = NULL;
+
+  while ((node = source(arg))) {
+#if defined(_SPLAY_THREADED) || defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_XOR_SIBLING)
+    struct splay_node *prev = count ? tail : NULL;
+#endif
+    _init_splay_node(node);
+    tail->right = node;
+#ifdef _SPLAY_THREADED
+    node->left = _thread(prev);
+#endif
 #ifdef _SPLAY_SIBLING_POINTER
-  return node->prev;
+    node->prev = prev;
+    if (prev) prev->next = node;
+#endif
+#ifdef _SPLAY_XOR_SIBLING
+    _xor_splice(prev, node, NULL);
 #endif
+    tail = node;
+    count ++;
+  }
 
-  struct splay_node *p;
-  if (node->left) goto move_prev;
-  int notUsed;
-  tree->root = _splay(tree->root, node, func, &notUsed);
+  tree->root = N.right;
+  _vine_to_tree(&tree->root, count);
+#ifdef _SPLAY_AUGMENT
+  _update_all(tree->root, tree->update);
+#endif
+#ifdef _SPLAY_SMALL_TREE
+  tree->count = count;
+  if (count < _SPLAY_SMALL_SIZE) _small_demote(tree);
+#endif
+  return count;
+}
+
+/**
+ * @brief    Frozen snapshot
+ *
+ * splay_freeze() collects the node pointers of the tree into an array laid out in Eytzinger
+ * order; the nodes themselves stay where they are. The descent does not branch on the
+ * comparison result, so it can prefetch ahead: the pointer slots of the descendants three
+ * levels down share one cache line, and those of the nodes two levels down were fetched on
+ * the level above, so the nodes themselves can be prefetched. splay_thaw() links the array
+ * back into a balanced tree. The tree is empty while frozen.
+ */
 
-move_prev:
-  for(p = node->left; p && p->right; p = p->right) {}
-  return p;
+static struct splay_node *_vine_to_eytzinger(struct splay_node **nodes, size_t k, size_t n,
+                                             struct splay_node *cur) {
+  if (k > n) return cur;
+  cur = _vine_to_eytzinger(nodes, 2 * k, n, cur);
+  nodes[k] = cur;
+  return _vine_to_eytzinger(nodes, 2 * k + 1, n, cur->right);
 }
 
-struct splay_node* splay_next(struct splay_tree *tree, struct splay_node *node, compare_func *func) {
-  if (!node || !tree->root) return NULL;
+int splay_freeze(struct splay_tree *tree, struct splay_frozen *frozen) {
+#ifdef _SPLAY_SMALL_TREE
+  if (!tree->root) _small_promote(tree);
+  tree->count = 0;
+#endif
+  frozen->nodes = NULL;
+  frozen->count = _tree_to_vine(&tree->root);
+  if (!frozen->count) return 0;
+
+  frozen->nodes = (struct splay_node **) malloc((frozen->count + 1) * sizeof(struct splay_node *));
+  if (!frozen->nodes) {
+    // the vine is still a valid (if degenerated) splay tree
+    frozen->count = 0;
+    return -1;
+  }
+  frozen->nodes[0] = NULL;
+  _vine_to_eytzinger(frozen->nodes, 1, frozen->count, tree->root);
+  tree->root = NULL;
+  return 0;
+}
 
+void splay_thaw(struct splay_frozen *frozen, struct splay_tree *tree) {
+  struct splay_node **nodes = frozen->nodes;
+  size_t n = frozen->count, k;
+
+  tree->root = n ? nodes[1] : NULL;
+#ifdef _SPLAY_SMALL_TREE
+  tree->count = n;
+#endif
+  for(k = 1; k <= n; k ++) {
+    nodes[k]->left  = (2 * k <= n) ? nodes[2 * k] : _thread(NULL);
+    nodes[k]->right = (2 * k + 1 <= n) ? nodes[2 * k + 1] : _thread(NULL);
+  }
+#ifdef _SPLAY_AUGMENT
+  // children have the bigger indexes
+  for(k = n; k >= 1 && tree->update; k --) {
+    tree->update(nodes[k]);
+  }
+#endif
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+  // in-order walk over the implicit tree
+  struct splay_node *prev = NULL;
+  for(k = n ? 1 : 0; k && 2 * k <= n; k = 2 * k) {}
+  while (k) {
 #ifdef _SPLAY_SIBLING_POINTER
-  return node->next;
+    nodes[k]->prev = prev;
+    nodes[k]->next = NULL;
+    if (prev) prev->next = nodes[k];
+#else
+    if (_is_thread(nodes[k]->left)) nodes[k]->left = _thread(prev);
+    if (prev && _is_thread(prev->right)) prev->right = _thread(nodes[k]);
+#endif
+    prev = nodes[k];
+    if (2 * k + 1 <= n) {
+      for(k = 2 * k + 1; 2 * k <= n; k = 2 * k) {}
+    } else {
+      while (k & 1) k >>= 1;
+      k >>= 1;
+    }
+  }
 #endif
 
-  struct splay_node *p;
-  if (node->right) goto move_next;
-  int notUsed;
-  tree->root = _splay(tree->root, node, func, &notUsed);
+  free(nodes);
+  frozen->nodes = NULL;
+  frozen->count = 0;
+}
+
+INLINE void _frozen_prefetch(struct splay_node **nodes, size_t k, size_t n) {
+  size_t i;
+  if (8 * k <= n) __builtin_prefetch(nodes + 8 * k);
+  for(i = 4 * k; i <= n && i < 4 * k + 4; i ++) __builtin_prefetch(nodes[i]);
+}
+
+struct splay_node* splay_frozen_search_greater(struct splay_frozen *frozen, struct splay_node *node, compare_func *func) {
+  struct splay_node **nodes = frozen->nodes;
+  size_t k = 1, n = frozen->count;
+  while (k <= n) {
+    _frozen_prefetch(nodes, k, n);
+    k = 2 * k + (func(nodes[k], node) < 0);
+  }
+  // drop the trailing right turns and the last left turn
+  k >>= __builtin_ffsl((long) ~k);
+  return k ? nodes[k] : NULL;
+}
 
-move_next:
-  for(p = node->right; p && p->left; p = p->left) {}
-  return p;
-}
\ No newline at end of file
+struct splay_node* splay_frozen_search_lower(struct splay_frozen *frozen, struct splay_node *node, compare_func *func) {
+  struct splay_node **nodes = frozen->nodes;
+  size_t k = 1, n = frozen->count;
+  while (k <= n) {
+    _frozen_prefetch(nodes, k, n);
+    k = 2 * k + (func(nodes[k], node) <= 0);
+  }
+  // drop the trailing left turns and the last right turn
+  k >>= __builtin_ffsl((long) k);
+  return k ? nodes[k] : NULL;
+}
+
+struct splay_node* splay_frozen_search(struct splay_frozen *frozen, struct splay_node *node, compare_func *func) {
+  struct splay_node *cur = splay_frozen_search_greater(frozen, node, func);
+  if (cur && func(cur, node) == 0) {
+    return cur;
+  }
+
+  return NULL;
+}
@@ -37,6 +37,18 @@ OTHER DEALINGS IN THE SOFTWARE.
 #define _SPLAY_RATIO (rand() % 3 < 1)
 #endif
 
+#if defined(_SPLAY_SMALL_TREE) && !defined(_SPLAY_SMALL_SIZE)
+#define _SPLAY_SMALL_SIZE 8
+#endif
+
+#if defined(_SPLAY_THREADED) && defined(_SPLAY_SIBLING_POINTER)
+#error "_SPLAY_THREADED and _SPLAY_SIBLING_POINTER are alternatives, pick one"
+#endif
+
+#if defined(_SPLAY_XOR_SIBLING) && defined(_SPLAY_SIBLING_POINTER)
+#error "_SPLAY_XOR_SIBLING and _SPLAY_SIBLING_POINTER are alternatives, pick one"
+#endif
+
 #ifdef __cplusplus
 
 #include <cstdio>
@@ -54,26 +66,118 @@ struct splay_node {
 #ifdef _SPLAY_SIBLING_POINTER
   struct splay_node *prev, *next;
 #endif
+
+#ifdef _SPLAY_XOR_SIBLING
+  uintptr_t sibling;  // prev ^ next
+#endif
 };
 
+#ifdef _SPLAY_THREADED
+// a missing child is stored as a thread to the in-order neighbour (or to NULL) with the low bit set
+#define _splay_is_thread(p)   (((uintptr_t) (p)) & 1)
+#define splay_left(p)         (_splay_is_thread((p)->left) ? NULL : (p)->left)
+#define splay_right(p)        (_splay_is_thread((p)->right) ? NULL : (p)->right)
+#else
+#define splay_left(p)         ((p)->left)
+#define splay_right(p)        ((p)->right)
+#endif
+
+#ifdef _SPLAY_XOR_SIBLING
+// position in the xor-linked order, the previous node is what decodes the next one
+struct splay_cursor {
+  struct splay_node *prev, *node;
+};
+#endif
+
+#ifdef _SPLAY_AUGMENT
+// recompute what the node keeps about its subtree from its own value and its children
+typedef void splay_update_func (struct splay_node *node);
+
+// called in order on the parts of a range: a node alone, or (subtree) all nodes under it
+typedef void splay_aggregate_func (struct splay_node *node, bool subtree, void *arg);
+#endif
+
 struct splay_tree {
   struct splay_node *root;
+
+#ifdef _SPLAY_AUGMENT
+  splay_update_func *update;
+#endif
+
+#ifdef _SPLAY_SMALL_TREE
+  // while root is NULL the nodes are kept sorted in small[0..count)
+  size_t count;
+  struct splay_node *small[_SPLAY_SMALL_SIZE];
+#endif
+};
+
+/**
+ * @brief    Read-only snapshot of a tree: node pointers in Eytzinger (BFS) order, 1-based,
+ *           the nodes are not moved
+ */
+struct splay_frozen {
+  struct splay_node **nodes;
+  size_t count;
 };
 
 typedef int compare_func (struct splay_node *a, struct splay_node *b);
 
 void splay_tree_init(struct splay_tree *tree);
+#ifdef _SPLAY_AUGMENT
+void splay_tree_init_augmented(struct splay_tree *tree, splay_update_func *update);
+#endif
 void splay_insert(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 void splay_delete(struct splay_tree *tree, struct splay_node *node, compare_func *func);
+size_t splay_delete_all(struct splay_tree *tree, struct splay_node *node, compare_func *func);
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+// multiset, equal nodes are kept in insertion order, [first, *end) are the nodes equal to node
+void splay_insert_multi(struct splay_tree *tree, struct splay_node *node, compare_func *func);
+// among equal nodes, node itself if it is linked in the tree, otherwise the first of them
+void splay_delete_multi(struct splay_tree *tree, struct splay_node *node, compare_func *func);
+struct splay_node* splay_equal_range(struct splay_tree *tree, struct splay_node *node,
+                                     compare_func *func, struct splay_node **end);
+size_t splay_count_equal(struct splay_tree *tree, struct splay_node *node, compare_func *func);
+#endif
 
 struct splay_node* splay_search(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 struct splay_node* splay_search_lower(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 struct splay_node* splay_search_greater(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 struct splay_node* splay_first(struct splay_tree *tree);
 struct splay_node* splay_last(struct splay_tree *tree);
+// unlink and return the minimum without calling a comparator, NULL if the tree is empty
+struct splay_node* splay_pop_first(struct splay_tree *tree);
 struct splay_node* splay_prev(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 struct splay_node* splay_next(struct splay_tree *tree, struct splay_node *node, compare_func *func);
 
+#ifdef _SPLAY_XOR_SIBLING
+// cursor->node is NULL past either end
+void splay_cursor_first(struct splay_tree *tree, struct splay_cursor *cursor);
+void splay_cursor_last(struct splay_tree *tree, struct splay_cursor *cursor);
+void splay_cursor_lower(struct splay_tree *tree, struct splay_node *node, compare_func *func, struct splay_cursor *cursor);
+void splay_cursor_greater(struct splay_tree *tree, struct splay_node *node, compare_func *func, struct splay_cursor *cursor);
+void splay_cursor_next(struct splay_cursor *cursor);
+void splay_cursor_prev(struct splay_cursor *cursor);
+#endif
+
+#ifdef _SPLAY_AUGMENT
+// feeds visit the O(log n) amortized parts covering the nodes in [lo, hi]
+void splay_range_aggregate(struct splay_tree *tree, struct splay_node *lo, struct splay_node *hi,
+                           compare_func *func, splay_aggregate_func *visit, void *arg);
+#endif
+
+// next node in ascending order, NULL at the end
+typedef struct splay_node *splay_source_func (void *arg);
+
+// link every node from source into an empty tree, balanced, in linear time; returns the count
+size_t splay_build(struct splay_tree *tree, splay_source_func *source, void *arg);
+
+int splay_freeze(struct splay_tree *tree, struct splay_frozen *frozen);
+void splay_thaw(struct splay_frozen *frozen, struct splay_tree *tree);
+struct splay_node* splay_frozen_search(struct splay_frozen *frozen, struct splay_node *node, compare_func *func);
+struct splay_node* splay_frozen_search_lower(struct splay_frozen *frozen, struct splay_node *node, compare_func *func);
+struct splay_node* splay_frozen_search_greater(struct splay_frozen *frozen, struct splay_node *node, compare_func *func);
+
 #ifdef __cplusplus
 }
 #endif
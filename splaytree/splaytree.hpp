@@ -0,0 +1,361 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_TREE_HPP
+#define _DUYNGUYEN_SPLAY_TREE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "splaytree.h"
+
+#if defined(_SPLAY_SIBLING_POINTER) || defined(_SPLAY_THREADED)
+
+/**
+ * @brief    std::set / std::map look-alikes on top of struct splay_tree (C++11)
+ *
+ * The containers own their nodes (one new per element, like the std ones) and iterate
+ * along the order links, so ++ / -- are O(1) and never restructure. Lookups splay as usual,
+ * which is why the const members still move nodes around; iterators and references stay
+ * valid until their element is erased.
+ *
+ * Compare has to be default constructible and stateless, it is rebuilt for each comparison
+ * because the C comparator gets no context. It must not throw.
+ */
+namespace splay {
+
+namespace detail {
+
+template <typename Value>
+struct node : splay_node {
+  template <typename... Args>
+  explicit node(Args&&... args) : value(std::forward<Args>(args)...) {}
+  Value value;
+};
+
+// what lookups by key pass down as the query node, the real nodes are never compared to it
+// as the first argument
+template <typename Key>
+struct query : splay_node {
+  const Key *key;
+};
+
+struct identity {
+  template <typename T>
+  const T& operator()(const T &value) const { return value; }
+};
+
+struct select_first {
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair &value) const { return value.first; }
+};
+
+template <typename Value, typename Key, typename KeyOf, typename Compare, bool Mutable>
+class tree {
+  typedef detail::node<Value> node_type;
+
+public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef Compare key_compare;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+
+  template <typename Ref, typename Ptr>
+  class basic_iterator {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef typename tree::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Ref reference;
+    typedef Ptr pointer;
+
+    basic_iterator() : tree_(nullptr), node_(nullptr) {}
+    // iterator to const_iterator (the copy constructor when they are the same)
+    basic_iterator(const basic_iterator<Value&, Value*> &other) : tree_(other.tree_), node_(other.node_) {}
+
+    reference operator*() const { return static_cast<node_type *>(node_)->value; }
+    pointer operator->() const { return &static_cast<node_type *>(node_)->value; }
+
+    basic_iterator& operator++() {
+      node_ = splay_next(tree_, node_, compare_nodes);
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator old = *this;
+      ++ *this;
+      return old;
+    }
+
+    // end() steps back onto the last node
+    basic_iterator& operator--() {
+      node_ = node_ ? splay_prev(tree_, node_, compare_nodes) : splay_last(tree_);
+      return *this;
+    }
+
+    basic_iterator operator--(int) {
+      basic_iterator old = *this;
+      -- *this;
+      return old;
+    }
+
+    bool operator==(const basic_iterator &other) const { return node_ == other.node_; }
+    bool operator!=(const basic_iterator &other) const { return node_ != other.node_; }
+
+  private:
+    friend class tree;
+    template <typename, typename> friend class basic_iterator;
+
+    basic_iterator(splay_tree *tree, splay_node *node) : tree_(tree), node_(node) {}
+
+    splay_tree *tree_;
+    splay_node *node_;
+  };
+
+  typedef basic_iterator<const Value&, const Value*> const_iterator;
+  typedef typename std::conditional<Mutable, basic_iterator<Value&, Value*>, const_iterator>::type iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  tree() : size_(0) { splay_tree_init(&tree_); }
+
+  template <typename InputIt>
+  tree(InputIt first, InputIt last) : tree() { insert(first, last); }
+
+  tree(std::initializer_list<value_type> values) : tree() { insert(values.begin(), values.end()); }
+
+  // the source is walked in order, so every insert lands next to the root
+  tree(const tree &other) : tree() { insert(other.begin(), other.end()); }
+
+  tree(tree &&other) : tree_(other.tree_), size_(other.size_) {
+    splay_tree_init(&other.tree_);
+    other.size_ = 0;
+  }
+
+  ~tree() { clear(); }
+
+  tree& operator=(tree other) {
+    swap(other);
+    return *this;
+  }
+
+  void swap(tree &other) {
+    std::swap(tree_, other.tree_);
+    std::swap(size_, other.size_);
+  }
+
+  iterator begin() { return iterator(&tree_, splay_first(&tree_)); }
+  const_iterator begin() const { return const_iterator(&tree_, splay_first(&tree_)); }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return iterator(&tree_, nullptr); }
+  const_iterator end() const { return const_iterator(&tree_, nullptr); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  key_compare key_comp() const { return key_compare(); }
+
+  iterator find(const key_type &key) { return iterator(&tree_, _search(key)); }
+  const_iterator find(const key_type &key) const { return const_iterator(&tree_, _search(key)); }
+  size_type count(const key_type &key) const { return _search(key) ? 1 : 0; }
+
+  iterator lower_bound(const key_type &key) { return iterator(&tree_, _lower_bound(key)); }
+  const_iterator lower_bound(const key_type &key) const { return const_iterator(&tree_, _lower_bound(key)); }
+  iterator upper_bound(const key_type &key) { return iterator(&tree_, _upper_bound(key)); }
+  const_iterator upper_bound(const key_type &key) const { return const_iterator(&tree_, _upper_bound(key)); }
+
+  std::pair<iterator, iterator> equal_range(const key_type &key) {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) { return _insert(KeyOf()(value), value); }
+  std::pair<iterator, bool> insert(value_type &&value) { return _insert(KeyOf()(value), std::move(value)); }
+
+  template <typename InputIt>
+  void insert(InputIt first, InputIt last) {
+    for(; first != last; ++ first) {
+      insert(*first);
+    }
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    node_type *node = new node_type(std::forward<Args>(args)...);
+    splay_node *found = splay_search(&tree_, node, compare_nodes);
+    if (found) {
+      delete node;
+      return std::make_pair(iterator(&tree_, found), false);
+    }
+    return std::make_pair(_link(node), true);
+  }
+
+  iterator erase(const_iterator pos) {
+    splay_node *node = pos.node_, *next = splay_next(&tree_, node, compare_nodes);
+    splay_delete(&tree_, node, compare_nodes);
+    delete static_cast<node_type *>(node);
+    size_ --;
+    return iterator(&tree_, next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last) {
+      first = erase(first);
+    }
+    return iterator(&tree_, last.node_);
+  }
+
+  size_type erase(const key_type &key) {
+    splay_node *node = _search(key);
+    if (!node) return 0;
+    erase(const_iterator(&tree_, node));
+    return 1;
+  }
+
+  // pops from the front, which needs no comparison
+  void clear() {
+    splay_node *node;
+    while ((node = splay_pop_first(&tree_))) {
+      delete static_cast<node_type *>(node);
+    }
+    size_ = 0;
+  }
+
+protected:
+  static const key_type& key_of(splay_node *node) { return KeyOf()(static_cast<node_type *>(node)->value); }
+
+  static int order(const key_type &lhs, const key_type &rhs) {
+    Compare less;
+    return less(lhs, rhs) ? -1 : less(rhs, lhs) ? 1 : 0;
+  }
+
+  static int compare_nodes(splay_node *lhs, splay_node *rhs) {
+    return order(key_of(lhs), key_of(rhs));
+  }
+
+  static int compare_query(splay_node *lhs, splay_node *rhs) {
+    return order(key_of(lhs), *static_cast<query<Key> *>(rhs)->key);
+  }
+
+  splay_node *_search(const key_type &key) const {
+    query<Key> q;
+    q.key = &key;
+    return splay_search(&tree_, &q, compare_query);
+  }
+
+  splay_node *_lower_bound(const key_type &key) const {
+    query<Key> q;
+    q.key = &key;
+    return splay_search_greater(&tree_, &q, compare_query);
+  }
+
+  splay_node *_upper_bound(const key_type &key) const {
+    splay_node *node = _lower_bound(key);
+    return (node && order(key_of(node), key) == 0) ? splay_next(&tree_, node, compare_nodes) : node;
+  }
+
+  // the key is looked up first, so that a present one costs no allocation
+  template <typename V>
+  std::pair<iterator, bool> _insert(const key_type &key, V &&value) {
+    splay_node *found = _search(key);
+    if (found) return std::make_pair(iterator(&tree_, found), false);
+    return std::make_pair(_link(new node_type(std::forward<V>(value))), true);
+  }
+
+  iterator _link(node_type *node) {
+    splay_insert(&tree_, node, compare_nodes);
+    size_ ++;
+    return iterator(&tree_, node);
+  }
+
+  mutable splay_tree tree_;
+  size_type size_;
+};
+
+} // namespace detail
+
+template <typename Key, typename Compare = std::less<Key>>
+class set : public detail::tree<Key, Key, detail::identity, Compare, false> {
+  typedef detail::tree<Key, Key, detail::identity, Compare, false> base;
+
+public:
+  using base::base;
+  set() = default;
+};
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class map : public detail::tree<std::pair<const Key, T>, Key, detail::select_first, Compare, true> {
+  typedef detail::tree<std::pair<const Key, T>, Key, detail::select_first, Compare, true> base;
+
+public:
+  typedef T mapped_type;
+
+  using base::base;
+  map() = default;
+
+  T& operator[](const Key &key) {
+    splay_node *found = this->_search(key);
+    if (found) return static_cast<detail::node<typename base::value_type> *>(found)->value.second;
+    return this->_link(new detail::node<typename base::value_type>(
+      std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()))->second;
+  }
+
+  T& at(const Key &key) {
+    typename base::iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("splay::map::at");
+    return it->second;
+  }
+
+  const T& at(const Key &key) const {
+    typename base::const_iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("splay::map::at");
+    return it->second;
+  }
+};
+
+} // namespace splay
+
+#endif /* _SPLAY_SIBLING_POINTER || _SPLAY_THREADED */
+
+#endif
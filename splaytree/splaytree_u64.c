@@ -0,0 +1,137 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INLINE
+  #ifdef __linux__
+    #define INLINE static inline
+  #else
+    #define INLINE
+  #endif
+#endif
+
+#include <stdlib.h>
+
+#include "splaytree_u64.h"
+
+// keys are compared inline, the callback only runs on equal keys of a prefix tree
+INLINE int _u64_cmp(struct splay_node_u64 *node, struct splay_node_u64 *query,
+                    compare_u64_func *tiebreak) {
+  if (node->key != query->key) return (node->key > query->key) ? 1 : -1;
+  return tiebreak ? tiebreak(node, query) : 0;
+}
+
+// the u64 instance of the template, with no update hook nor xor-linked order to keep up and
+// names of its own so that it links next to the generic one
+#undef _SPLAY_AUGMENT
+#undef _SPLAY_XOR_SIBLING
+#define _SPLAY_NODE             struct splay_node_u64
+#define _SPLAY_TREE             struct splay_tree_u64
+#define _SPLAY_FUNC             compare_u64_func
+#define _SPLAY_CMP(node, query) _u64_cmp(node, query, func)
+
+#define _right_rotate         _right_rotate_u64
+#define _left_rotate          _left_rotate_u64
+#define _leftmost             _leftmost_u64
+#define _rightmost            _rightmost_u64
+#define _pred                 _pred_u64
+#define _succ                 _succ_u64
+#define _init_splay_node      _init_splay_node_u64
+#define _bias_cmp             _bias_cmp_u64
+#define _splay_bias           _splay_bias_u64
+#define _splay                _splay_u64
+#define _link_root            _link_root_u64
+#define _tree_insert          _tree_insert_u64
+#define _unlink_root         _unlink_root_u64
+#define _tree_delete          _tree_delete_u64
+#define _tree_prev            _tree_prev_u64
+#define _tree_next            _tree_next_u64
+#define _tree_search          _tree_search_u64
+#define _tree_search_lower    _tree_search_lower_u64
+#define _tree_search_greater  _tree_search_greater_u64
+#define _tree_first           _tree_first_u64
+#define _tree_last            _tree_last_u64
+
+#include "splaytree.inc"
+
+/**
+ * @brief    Below is the implementation of all public functions
+ */
+void splay_tree_u64_init(struct splay_tree_u64 *tree) {
+  tree->root = NULL;
+  tree->tiebreak = NULL;
+}
+
+void splay_tree_u64_init_prefix(struct splay_tree_u64 *tree, compare_u64_func *func) {
+  tree->root = NULL;
+  tree->tiebreak = func;
+}
+
+uint64_t splay_key_prefix(const void *key, size_t len) {
+  const uint8_t *bytes = (const uint8_t *) key;
+  uint64_t prefix = 0;
+  for(size_t idx = 0; idx < sizeof(uint64_t); idx ++) {
+    prefix = (prefix << 8) | (idx < len ? bytes[idx] : 0);
+  }
+  return prefix;
+}
+
+void splay_u64_insert(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  _tree_insert(tree, node, tree->tiebreak);
+}
+
+void splay_u64_delete(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  _tree_delete(tree, node, tree->tiebreak);
+}
+
+struct splay_node_u64* splay_u64_search(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  return _tree_search(tree, node, tree->tiebreak);
+}
+
+struct splay_node_u64* splay_u64_search_lower(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  return _tree_search_lower(tree, node, tree->tiebreak);
+}
+
+struct splay_node_u64* splay_u64_search_greater(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  return _tree_search_greater(tree, node, tree->tiebreak);
+}
+
+struct splay_node_u64* splay_u64_first(struct splay_tree_u64 *tree) {
+  return _tree_first(tree);
+}
+
+struct splay_node_u64* splay_u64_last(struct splay_tree_u64 *tree) {
+  return _tree_last(tree);
+}
+
+struct splay_node_u64* splay_u64_prev(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  return _tree_prev(tree, node, tree->tiebreak);
+}
+
+struct splay_node_u64* splay_u64_next(struct splay_tree_u64 *tree, struct splay_node_u64 *node) {
+  return _tree_next(tree, node, tree->tiebreak);
+}
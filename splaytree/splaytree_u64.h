@@ -0,0 +1,87 @@
+/*
+Copyright (C) 2021-present Duy Nguyen <duynguyen.ori75@gmail.com>
+All rights reserved.
+
+Last modification: October 19, 2026
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _DUYNGUYEN_SPLAY_TREE_U64
+#define _DUYNGUYEN_SPLAY_TREE_U64
+
+#include "splaytree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief    Splay tree specialized for uint64_t keys
+ *
+ * The key lives in the node right after the links and is compared inline, so a search
+ * touches one cache line per visited node and never calls back into the enclosing struct.
+ * Queries are nodes with only the key set, as in the generic API. The code is the generic
+ * tree's (splaytree.inc) and follows the same layout flags, except _SPLAY_XOR_SIBLING and
+ * _SPLAY_AUGMENT which it ignores.
+ *
+ * A prefix tree (splay_tree_u64_init_prefix) stores the first 8 bytes of a byte-string key
+ * as the key, see splay_key_prefix(). Most comparisons are decided by the prefixes alone,
+ * the full comparator only runs on equal prefixes and is the one touching the payload.
+ */
+struct splay_node_u64 {
+  struct splay_node_u64 *left, *right;
+
+#ifdef _SPLAY_SIBLING_POINTER
+  struct splay_node_u64 *prev, *next;
+#endif
+
+  uint64_t key;
+};
+
+typedef int compare_u64_func (struct splay_node_u64 *a, struct splay_node_u64 *b);
+
+struct splay_tree_u64 {
+  struct splay_node_u64 *root;
+  compare_u64_func *tiebreak;
+};
+
+void splay_tree_u64_init(struct splay_tree_u64 *tree);
+void splay_tree_u64_init_prefix(struct splay_tree_u64 *tree, compare_u64_func *func);
+uint64_t splay_key_prefix(const void *key, size_t len);
+
+void splay_u64_insert(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+void splay_u64_delete(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+
+struct splay_node_u64* splay_u64_search(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+struct splay_node_u64* splay_u64_search_lower(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+struct splay_node_u64* splay_u64_search_greater(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+struct splay_node_u64* splay_u64_first(struct splay_tree_u64 *tree);
+struct splay_node_u64* splay_u64_last(struct splay_tree_u64 *tree);
+struct splay_node_u64* splay_u64_prev(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+struct splay_node_u64* splay_u64_next(struct splay_tree_u64 *tree, struct splay_node_u64 *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif